@@ -9,16 +9,48 @@
  * Fase 1:
  *  - Antena: Armazena a frequncia, coordenadas (x, y) e ponteiro para a prxima antena.
  *  - Nefasto: Armazena coordenadas de efeitos nefastos e ponteiro para o prximo.
+ *  - MapaFrequencias: Coordenadas das antenas agrupadas por frequncia (GrupoFrequencia),
+ *                     usado no processamento de mapas por bandas de linhas.
  *
  * Fase 2:
  *  - Adjacente: Representa uma ligao entre vrtices no grafo.
  *  - Vertice: Representa uma antena com lista de adjacentes.
- *  - Grafo: Contm todos os vrtices (antenas) e respetivas ligaes.
+ *  - Grafo: Contm todos os vrtices (antenas) e respetivas ligaes,
+ *           com ndices por frequncia e por coordenadas.
+ *  - GrafoImutavel / GrafoPublicado: Cpias imutveis do grafo publicadas para leitura concorrente.
+ *  - MatrizDistancias: Distncias em saltos entre todos os vrtices, excentricidades e dimetro.
+ *  - ArvoreVizinhos / Vizinho: rvores k-d por frequncia para procurar as antenas mais prximas.
+ *
+ * Representao compacta:
+ *  - RasterCompacto: Mapa de bits de nefastos com lista esparsa de antenas.
+ *  - IndiceEspacial: Pontos ordenados por linha e coluna, para desenhar apenas uma janela do mapa.
+ *
+ * Mapa de interferncia:
+ *  - CelulaInterferencia / MapaInterferencia: Nmero de pares de antenas que atingem cada clula.
+ *
+ * Verses de antenas:
+ *  - NoVersao / VersaoAntenas: Conjuntos de antenas com partilha de estrutura entre cenrios.
+ *  - NefastosVersao: Nefastos calculados para uma verso, partilhados pelas verses iguais.
+ *
+ * Servidor de consultas:
+ *  - TextoResposta / EstadoServidor: Respostas do protocolo e estado mantido entre pedidos.
+ *
+ * Processamento em lote:
+ *  - ResultadoMapa: Resultados calculados para cada ficheiro de mapa.
  */
 
 #ifndef DADOS_H
 #define DADOS_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define MAX_VERTICES 1000
+#define NUM_FREQUENCIAS 256      // Uma entrada por cada valor possvel de char
+#define TAM_TABELA_COORD 2048    // Nmero de posies da tabela de disperso por coordenadas
+#define MAX_LEITORES 64          // Nmero mximo de threads de leitura de um grafo publicado
+
 #pragma region Fase 1 : Insero e Listagem de Antenas
  /// <summary>
  /// Estrutura que representa uma antena com frequncia, coordenadas (x, y)
@@ -38,38 +70,298 @@ typedef struct nefasto {
     int x, y;
     struct nefasto* next;
 } Nefasto;
+
+/// <summary>
+/// Estrutura que representa um par de coordenadas (x, y).
+/// </summary>
+typedef struct {
+    int x, y;
+} Coordenada;
+
+/// <summary>
+/// Estrutura que guarda as coordenadas de todas as antenas de uma frequncia
+/// num vetor dinmico, ordenado por linha (x) e depois por coluna (y).
+/// </summary>
+typedef struct {
+    Coordenada* pontos;
+    int total;
+    int capacidade;
+} GrupoFrequencia;
+
+/// <summary>
+/// Estrutura que representa um mapa apenas pelas coordenadas das antenas,
+/// agrupadas por frequncia, sem guardar as clulas vazias do ficheiro.
+/// </summary>
+typedef struct {
+    GrupoFrequencia grupos[NUM_FREQUENCIAS];
+    int totalAntenas;
+    int nLinhas, nColunas; // Dimenses do mapa lido do ficheiro
+} MapaFrequencias;
 #pragma endregion
 
 #pragma region Fase 2 : Representao com Grafos
 
 /// <summary>
 /// Estrutura que representa uma aresta (ligao) para um vrtice adjacente
-/// atravs do ndice do destino. Utiliza uma lista ligada de adjacncias.
+/// atravs do ndice do destino. Utiliza uma lista duplamente ligada de adjacncias
+/// e guarda a aresta inversa (destino -> origem), para que remover um vrtice
+/// no obrigue a percorrer as listas dos vizinhos.
 /// </summary>
 typedef struct adjacente {
     int destino;
     struct adjacente* seguinte;
+    struct adjacente* anterior;
+    struct adjacente* inversa;
 } Adjacente;
 
 /// <summary>
 /// Estrutura que representa um vrtice do grafo, correspondente a uma antena
 /// com frequncia e coordenadas (x, y), e ponteiro para a sua lista de adjacentes.
+/// Os ndices seguinteFreq/anteriorFreq ligam os vrtices da mesma frequncia
+/// e seguinteCoord encadeia os vrtices na mesma posio da tabela de coordenadas.
 /// </summary>
 typedef struct {
     char freq;
     int x, y;
     Adjacente* adjacentes;
+    Adjacente* ultimoAdjacente;
+    int seguinteFreq, anteriorFreq;
+    int seguinteCoord;
 } Vertice;
 
 /// <summary>
 /// Estrutura que representa o grafo completo como uma lista de vrtices,
-/// com tamanho atual e vetor fixo para armazenar at 1000 vrtices.
+/// com tamanho atual e vetor fixo para armazenar at MAX_VERTICES vrtices.
+/// Mantm ainda dois ndices atualizados a cada insero/remoo:
+/// listas de vrtices por frequncia e tabela de disperso por coordenadas.
 /// </summary>
 typedef struct {
     int tamanho;
-    Vertice vertices[1000]; // MAX_VERTICES
+    Vertice vertices[MAX_VERTICES];
+    int inicioFreq[NUM_FREQUENCIAS];   // Primeiro vrtice de cada frequncia (-1 se nenhum)
+    int totalFreq[NUM_FREQUENCIAS];    // Nmero de vrtices de cada frequncia
+    int tabelaCoord[TAM_TABELA_COORD]; // Primeiro vrtice de cada posio da tabela (-1 se vazia)
 } Grafo;
 
+/// <summary>
+/// Estrutura que representa uma cpia imutvel do grafo, publicada para leitura concorrente.
+/// As adjacncias ficam em vetores contnuos (as de v entre inicioAdjacentes[v] e inicioAdjacentes[v + 1])
+/// e nenhum campo  alterado depois de publicada, pelo que vrias threads a podem ler sem trincos.
+/// </summary>
+typedef struct grafoImutavel {
+    int tamanho;
+    char* freqs;
+    Coordenada* posicoes;
+    int* inicioAdjacentes;             // tamanho + 1 posies
+    int* adjacentes;
+    int inicioFrequencia[NUM_FREQUENCIAS + 1];
+    int* porFrequencia;                // Vrtices agrupados por frequncia
+    int* tabelaCoord;                  // Endereamento aberto (-1 nas posies livres)
+    int capacidadeTabela;
+    int* componente;                   // Componente ligada de cada vrtice
+    int totalComponentes;
+    uint64_t epocaRetirado;            // poca em que deixou de ser a verso publicada
+    struct grafoImutavel* seguinteRetirado;
+} GrafoImutavel;
+
+/// <summary>
+/// Estrutura com a poca anunciada por uma thread de leitura (0 quando no est a ler).
+/// Ocupa uma linha de cache (64 bytes), para que leitores diferentes no escrevam na mesma linha.
+/// </summary>
+typedef struct {
+    _Atomic uint64_t epoca;
+    atomic_int ocupado;
+    char preenchimento[64 - sizeof(uint64_t) - sizeof(atomic_int)];
+} EpocaLeitor;
+
+/// <summary>
+/// Estrutura que publica o grafo para leitura concorrente. O escritor altera a sua cpia de trabalho,
+/// cria uma nova cpia imutvel e troca-a atomicamente com a atual; a anterior s  libertada
+/// quando nenhum leitor a pode estar a usar (reclamao por pocas).
+/// </summary>
+typedef struct {
+    _Atomic(GrafoImutavel*) atual;
+    _Atomic uint64_t epocaGlobal;
+    EpocaLeitor leitores[MAX_LEITORES];
+    Grafo* grafo;                      // Cpia de trabalho, usada apenas pelo escritor
+    GrafoImutavel* retirados;          // Verses  espera de serem libertadas
+} GrafoPublicado;
+
+/// <summary>
+/// Estrutura com as distncias em nmero de ligaes (saltos) entre todos os pares de vrtices,
+/// a excentricidade de cada vrtice e o dimetro do grafo.
+/// </summary>
+typedef struct {
+    int tamanho;
+    int* distancias;                   // tamanho * tamanho (-1 se no houver caminho); NULL se no foi pedida
+    int* excentricidade;               // Maior distncia a um vrtice alcanvel
+    int diametro;                      // Maior excentricidade
+} MatrizDistancias;
+
+/// <summary>
+/// Estrutura com uma rvore k-d por frequncia para procurar as antenas mais prximas de um ponto.
+/// Os pontos de cada frequncia ocupam as posies [inicioFrequencia[f], inicioFrequencia[f + 1])
+/// e formam uma rvore implcita: a raiz de um intervalo  o ponto do meio, a subrvore esquerda
+/// fica antes e a direita depois, alternando entre a coordenada X e a Y em cada nvel.
+/// </summary>
+typedef struct {
+    Coordenada* pontos;
+    int* vertices;                     // ndice no grafo de cada ponto
+    int inicioFrequencia[NUM_FREQUENCIAS + 1];
+} ArvoreVizinhos;
+
+/// <summary>
+/// Estrutura que representa uma antena encontrada numa procura de vizinhos, com o quadrado da distncia.
+/// </summary>
+typedef struct {
+    int vertice;
+    long long distancia2;
+} Vizinho;
+
+#pragma endregion
+
+#pragma region Representao Compacta do Mapa
+
+/// <summary>
+/// Estrutura que representa a matriz de antenas e nefastos de forma compacta:
+/// os nefastos num mapa de bits contnuo (um bit por clula, linha a linha) e as antenas
+/// numa lista esparsa, ordenada pelo ndice da clula (linha * nCols + coluna).
+/// </summary>
+typedef struct {
+    int minX, minY;          // Coordenadas da primeira linha e da primeira coluna
+    int nRows, nCols;
+    uint64_t* nefastos;      // (nRows * nCols + 63) / 64 palavras
+    int totalAntenas;
+    int64_t* celulas;        // ndice da clula de cada antena, por ordem crescente
+    char* freqs;             // Frequncia de cada antena
+} RasterCompacto;
+
+/// <summary>
+/// Estrutura que representa um ndice espacial de pontos (antenas ou nefastos),
+/// ordenados por linha e depois por coluna, sem repetidos, para consultas por janela.
+/// </summary>
+typedef struct {
+    Coordenada* pontos;
+    char* freqs;             // Frequncia de cada ponto (NULL no ndice de nefastos)
+    int total;
+} IndiceEspacial;
+
+#pragma endregion
+
+#pragma region Mapa de Interferncia
+
+/// <summary>
+/// Estrutura que representa uma entrada do mapa de interferncia: o nmero de vezes que uma clula
+///  atingida por pares de antenas (no total, ou apenas de uma frequncia).
+/// Uma entrada com contagem 0  uma posio livre da tabela de disperso.
+/// </summary>
+typedef struct {
+    int x, y;
+    char freq;               // Frequncia da entrada (0 nas entradas totais por clula)
+    int contagem;
+} CelulaInterferencia;
+
+/// <summary>
+/// Estrutura que guarda o mapa de interferncia em duas tabelas de disperso de endereamento aberto:
+/// contagem total por clula e contagem por clula e frequncia. As tabelas crescem com o nmero
+/// de clulas distintas atingidas (at metade da capacidade), e no com o nmero de pares.
+/// </summary>
+typedef struct {
+    CelulaInterferencia* celulas;
+    size_t capacidadeCelulas, totalCelulas;
+    CelulaInterferencia* porFrequencia;
+    size_t capacidadeFrequencia, totalPorFrequencia;
+    long long totalImpactos;
+    long long impactosFrequencia[NUM_FREQUENCIAS];
+} MapaInterferencia;
+
+#pragma endregion
+
+#pragma region Verses de Antenas
+
+/// <summary>
+/// Estrutura que representa um n de uma rvore persistente de antenas (treap ordenada por linha
+/// e coluna, com prioridade calculada a partir das coordenadas). Os ns nunca so alterados depois
+/// de criados e podem ser partilhados por vrias verses; referencias conta quem aponta para o n.
+/// </summary>
+typedef struct noVersao {
+    char freq;
+    int x, y;
+    unsigned int prioridade;
+    int referencias;
+    struct noVersao* esq;
+    struct noVersao* dir;
+} NoVersao;
+
+/// <summary>
+/// Estrutura com os nefastos calculados para um conjunto de antenas, partilhada pelas
+/// verses que tm exatamente as mesmas antenas.
+/// </summary>
+typedef struct {
+    IndiceEspacial indice;
+    int referencias;
+} NefastosVersao;
+
+/// <summary>
+/// Estrutura que representa uma verso (cenrio) de um conjunto de antenas.
+/// Uma verso derivada partilha a rvore da verso de origem e s cria os ns que altera.
+/// Os resultados derivados so calculados apenas quando pedidos e guardados at a verso mudar.
+/// </summary>
+typedef struct {
+    NoVersao* raiz;
+    int totalAntenas;
+    NefastosVersao* nefastos;    // NULL se ainda no foram calculados
+    int componentesCalculados;
+    int totalComponentes;        // -1 se houver mais de MAX_VERTICES antenas
+} VersaoAntenas;
+
+#pragma endregion
+
+#pragma region Servidor de Consultas
+
+/// <summary>
+/// Estrutura que representa um texto de resposta que cresce  medida que so acrescentadas linhas.
+/// </summary>
+typedef struct {
+    char* dados;
+    size_t tamanho, capacidade;
+} TextoResposta;
+
+/// <summary>
+/// Estrutura com o estado mantido pelo servidor de consultas entre pedidos: o mapa  lido uma nica vez
+/// e o grafo publicado, o raster compacto e os ndices espaciais ficam prontos a responder.
+/// Mapas com mais de MAX_VERTICES antenas so servidos sem grafo (s NEFASTO e JANELA).
+/// </summary>
+typedef struct {
+    GrafoPublicado grafo;
+    int grafoDisponivel;
+    int leitor;
+    RasterCompacto raster;
+    IndiceEspacial antenas, nefastos;
+    long long totalPedidos;
+} EstadoServidor;
+
+#pragma endregion
+
+#pragma region Processamento em Lote
+
+/// <summary>
+/// Estrutura com o resultado do processamento de um ficheiro de mapa no modo em lote.
+/// Cada ficheiro tem o seu prprio resultado, preenchido apenas pela tarefa que o processa.
+/// </summary>
+typedef struct {
+    const char* ficheiro;
+    int sucesso;
+    char erro[128];
+    int nLinhas, nColunas;        // Dimenses do ficheiro
+    int totalAntenas;
+    int totalFrequencias;
+    int rasterRows, rasterCols;   // Dimenses da matriz com nefastos
+    long long totalNefastos;
+    int totalArestas;             // -1 se o mapa exceder MAX_VERTICES
+    int totalComponentes;         // -1 se o mapa exceder MAX_VERTICES
+} ResultadoMapa;
+
 #pragma endregion
 
 #endif  // DADOS_H
@@ -5,11 +5,14 @@
  *  @project EDA
  *
  *  Implementa todas as funes para manipulao das listas de antenas e nefastos,bem como funes auxiliares para criao, manipulao da matriz e carregamento de uma matriz atravs de um ficheiro txt.
+ *  Inclui ainda o processamento por bandas de linhas, para mapas que no cabem inteiros em memria.
  *  
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "dados.h"
 #include "funcoes.h"
 
@@ -369,4 +372,325 @@ Antena* carregarAntenasDeFicheiro(const char* filename, Antena* listaExistente)
 
 #pragma endregion
 
+#pragma region Funes de Processamento em Bandas
+
+/// <summary>
+/// Inicializa um mapa de frequncias vazio.
+/// </summary>
+/// <param name="mapa">Mapa a inicializar.</param>
+void inicializarMapaFrequencias(MapaFrequencias* mapa) {
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        mapa->grupos[f].pontos = NULL;
+        mapa->grupos[f].total = 0;
+        mapa->grupos[f].capacidade = 0;
+    }
+    mapa->totalAntenas = 0;
+    mapa->nLinhas = 0;
+    mapa->nColunas = 0;
+}
+
+/// <summary>
+/// Acrescenta uma coordenada ao fim de um grupo de frequncia, aumentando o vetor quando necessrio.
+/// </summary>
+/// <param name="grupo">Grupo de frequncia.</param>
+/// <param name="x">Coordenada X da antena.</param>
+/// <param name="y">Coordenada Y da antena.</param>
+/// <returns>1 se a coordenada foi acrescentada, 0 em caso de erro de alocao.</returns>
+int adicionarCoordenadaGrupo(GrupoFrequencia* grupo, int x, int y) {
+    if (grupo->total == grupo->capacidade) {
+        int novaCapacidade = grupo->capacidade ? grupo->capacidade * 2 : 16;
+        Coordenada* novos = realloc(grupo->pontos, novaCapacidade * sizeof(Coordenada));
+        if (!novos) return 0;
+        grupo->pontos = novos;
+        grupo->capacidade = novaCapacidade;
+    }
+    grupo->pontos[grupo->total].x = x;
+    grupo->pontos[grupo->total].y = y;
+    grupo->total++;
+    return 1;
+}
+
+/// <summary>
+/// L um mapa j aberto carcter a carcter, guardando apenas as coordenadas das antenas
+/// agrupadas por frequncia. As linhas no ficam em memria, pelo que no h limite de largura.
+/// As coordenadas seguem a conveno de carregarAntenasDeFicheiro (x = linha, y = coluna, a comear em 1).
+/// No escreve mensagens, podendo ser usada em paralelo com mapas diferentes.
+/// </summary>
+/// <param name="fp">Ficheiro aberto para leitura.</param>
+/// <param name="mapa">Mapa de frequncias (inicializado) onde so guardadas as antenas.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro de alocao.</returns>
+int lerMapaFrequencias(FILE* fp, MapaFrequencias* mapa) {
+    int x = 1, y = 1;
+    int c;
+    while ((c = getc(fp)) != EOF) {
+        if (c == '\n') {
+            if (y - 1 > mapa->nColunas) mapa->nColunas = y - 1;
+            x++;
+            y = 1;
+            continue;
+        }
+        if (c == '\r') continue;
+
+        if (c != '.' && c != ' ') {
+            if (!adicionarCoordenadaGrupo(&mapa->grupos[(unsigned char)c], x, y))
+                return 0;
+            mapa->totalAntenas++;
+        }
+        y++;
+    }
+    // ltima linha sem quebra de linha no fim do ficheiro
+    if (y > 1) {
+        if (y - 1 > mapa->nColunas) mapa->nColunas = y - 1;
+        x++;
+    }
+    mapa->nLinhas = x - 1;
+    return 1;
+}
+
+/// <summary>
+/// Carrega um ficheiro de mapa para um mapa de frequncias (ver lerMapaFrequencias).
+/// </summary>
+/// <param name="filename">Nome do ficheiro a carregar.</param>
+/// <param name="mapa">Mapa de frequncias (inicializado) onde so guardadas as antenas.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int carregarMapaFrequencias(const char* filename, MapaFrequencias* mapa) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        perror("Erro ao abrir ficheiro");
+        return 0;
+    }
+
+    int ok = lerMapaFrequencias(fp, mapa);
+
+    fclose(fp);
+    return ok;
+}
+
+/// <summary>
+/// Liberta os vetores de coordenadas de todos os grupos do mapa.
+/// </summary>
+/// <param name="mapa">Mapa de frequncias a libertar.</param>
+void libertarMapaFrequencias(MapaFrequencias* mapa) {
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        free(mapa->grupos[f].pontos);
+    }
+    inicializarMapaFrequencias(mapa);
+}
+
+/// <summary>
+/// Compara duas coordenadas por linha e depois por coluna (para qsort).
+/// </summary>
+static int compararCoordenadas(const void* a, const void* b) {
+    const Coordenada* ca = (const Coordenada*)a;
+    const Coordenada* cb = (const Coordenada*)b;
+    if (ca->x != cb->x) return (ca->x < cb->x) ? -1 : 1;
+    if (ca->y != cb->y) return (ca->y < cb->y) ? -1 : 1;
+    return 0;
+}
+
+/// <summary>
+/// Converte uma lista ligada de antenas num mapa de frequncias, com cada grupo ordenado por linha e coluna.
+/// </summary>
+/// <param name="lista">Lista de antenas.</param>
+/// <param name="mapa">Mapa de frequncias (inicializado) onde so guardadas as antenas.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int converterAntenasParaMapa(const Antena* lista, MapaFrequencias* mapa) {
+    for (const Antena* a = lista; a != NULL; a = a->next) {
+        if (!adicionarCoordenadaGrupo(&mapa->grupos[(unsigned char)a->freq], a->x, a->y))
+            return 0;
+        mapa->totalAntenas++;
+        if (a->x > mapa->nLinhas) mapa->nLinhas = a->x;
+        if (a->y > mapa->nColunas) mapa->nColunas = a->y;
+    }
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (mapa->grupos[f].total > 1)
+            qsort(mapa->grupos[f].pontos, mapa->grupos[f].total, sizeof(Coordenada), compararCoordenadas);
+    }
+    return 1;
+}
+
+/// <summary>
+/// Diviso inteira arredondada para baixo (tambm para valores negativos).
+/// </summary>
+static int divisaoPorDefeito(int a, int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/// <summary>
+/// Procura, num grupo ordenado por linha, o primeiro ponto com x maior ou igual ao indicado.
+/// </summary>
+/// <param name="grupo">Grupo de frequncia ordenado por linha.</param>
+/// <param name="x">Linha a procurar.</param>
+/// <returns>ndice do primeiro ponto com linha >= x (ou o total, se no existir).</returns>
+int primeiroPontoComLinha(const GrupoFrequencia* grupo, int x) {
+    int inicio = 0, fim = grupo->total;
+    while (inicio < fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        if (grupo->pontos[meio].x < x)
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+    return inicio;
+}
+
+/// <summary>
+/// Calcula os limites da matriz tal como criarMatrizComNefastos (antenas, nefastos e pelo menos (1,1)),
+/// mas sem gerar os nefastos: em cada frequncia, os nefastos mais afastados so 2*min - max e 2*max - min.
+/// </summary>
+/// <param name="mapa">Mapa de frequncias com as antenas.</param>
+/// <param name="minX">Ponteiro onde  guardada a menor linha.</param>
+/// <param name="maxX">Ponteiro onde  guardada a maior linha.</param>
+/// <param name="minY">Ponteiro onde  guardada a menor coluna.</param>
+/// <param name="maxY">Ponteiro onde  guardada a maior coluna.</param>
+void calcularLimitesMapa(const MapaFrequencias* mapa, int* minX, int* maxX, int* minY, int* maxY) {
+    *minX = INT_MAX; *minY = INT_MAX;
+    *maxX = INT_MIN; *maxY = INT_MIN;
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        if (grupo->total == 0) continue;
+
+        int gMinX = INT_MAX, gMinY = INT_MAX, gMaxX = INT_MIN, gMaxY = INT_MIN;
+        for (int i = 0; i < grupo->total; i++) {
+            if (grupo->pontos[i].x < gMinX) gMinX = grupo->pontos[i].x;
+            if (grupo->pontos[i].x > gMaxX) gMaxX = grupo->pontos[i].x;
+            if (grupo->pontos[i].y < gMinY) gMinY = grupo->pontos[i].y;
+            if (grupo->pontos[i].y > gMaxY) gMaxY = grupo->pontos[i].y;
+        }
+        if (grupo->total >= 2) {
+            int nMinX = 2 * gMinX - gMaxX, nMaxX = 2 * gMaxX - gMinX;
+            int nMinY = 2 * gMinY - gMaxY, nMaxY = 2 * gMaxY - gMinY;
+            gMinX = nMinX; gMaxX = nMaxX;
+            gMinY = nMinY; gMaxY = nMaxY;
+        }
+        if (gMinX < *minX) *minX = gMinX;
+        if (gMaxX > *maxX) *maxX = gMaxX;
+        if (gMinY < *minY) *minY = gMinY;
+        if (gMaxY > *maxY) *maxY = gMaxY;
+    }
+
+    // Garante que a matriz comea pelo menos em (1,1)
+    if (*minX > 1) *minX = 1;
+    if (*minY > 1) *minY = 1;
+}
+
+/// <summary>
+/// Preenche uma banda de linhas [linhaInicio, linhaFim] com as antenas e os nefastos que lhe pertencem.
+/// Os nefastos so gerados como 2q - p para cada par (p, q) da mesma frequncia; como os grupos esto
+/// ordenados por linha, para cada p s se percorrem os q cujo simtrico cai dentro da banda.
+/// </summary>
+/// <param name="mapa">Mapa de frequncias com as antenas.</param>
+/// <param name="banda">Linhas da banda (cada uma com nCols + 1 posies).</param>
+/// <param name="linhaInicio">Primeira linha (coordenada X) da banda.</param>
+/// <param name="linhaFim">ltima linha (coordenada X) da banda.</param>
+/// <param name="minY">Coordenada Y correspondente  primeira coluna.</param>
+/// <param name="nCols">Nmero de colunas da banda.</param>
+void preencherBanda(const MapaFrequencias* mapa, char** banda, int linhaInicio, int linhaFim, int minY, int nCols) {
+    for (int i = 0; i <= linhaFim - linhaInicio; i++) {
+        memset(banda[i], '.', nCols);
+        banda[i][nCols] = '\0';
+    }
+
+    // Antenas da banda
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = primeiroPontoComLinha(grupo, linhaInicio); i < grupo->total && grupo->pontos[i].x <= linhaFim; i++) {
+            banda[grupo->pontos[i].x - linhaInicio][grupo->pontos[i].y - minY] = (char)f;
+        }
+    }
+
+    // Nefastos da banda, sem sobrepor antenas
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        if (grupo->total < 2) continue;
+
+        for (int i = 0; i < grupo->total; i++) {
+            const Coordenada* p = &grupo->pontos[i];
+            // 2*q.x - p.x pertence  banda  <=>  q.x entre ceil((linhaInicio + p.x) / 2) e floor((linhaFim + p.x) / 2)
+            int qMin = -divisaoPorDefeito(-(linhaInicio + p->x), 2);
+            int qMax = divisaoPorDefeito(linhaFim + p->x, 2);
+
+            for (int j = primeiroPontoComLinha(grupo, qMin); j < grupo->total && grupo->pontos[j].x <= qMax; j++) {
+                if (j == i) continue;
+                int linha = 2 * grupo->pontos[j].x - p->x - linhaInicio;
+                int coluna = 2 * grupo->pontos[j].y - p->y - minY;
+                if (banda[linha][coluna] == '.')
+                    banda[linha][coluna] = '#';
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Escreve a matriz de antenas e nefastos de um mapa por bandas de linhas, sem nunca criar a matriz completa.
+/// O resultado  igual ao de criarMatrizComNefastos seguido de imprimirMatriz, mas a memria usada
+/// limita-se a uma banda (alturaBanda x colunas) e s coordenadas das antenas.
+/// </summary>
+/// <param name="mapa">Mapa de frequncias com as antenas.</param>
+/// <param name="alturaBanda">Nmero de linhas de cada banda.</param>
+/// <param name="saida">Ficheiro onde  escrita a matriz (por exemplo, stdout).</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int imprimirMapaEmBandas(const MapaFrequencias* mapa, int alturaBanda, FILE* saida) {
+    if (mapa->totalAntenas == 0) {
+        printf("Lista de antenas vazia. Sem dados para criar a matriz.\n");
+        return 0;
+    }
+    if (alturaBanda <= 0) {
+        printf("Altura de banda invlida: %d\n", alturaBanda);
+        return 0;
+    }
+
+    int minX, maxX, minY, maxY;
+    calcularLimitesMapa(mapa, &minX, &maxX, &minY, &maxY);
+    int nRows = maxX - minX + 1;
+    int nCols = maxY - minY + 1;
+    if (alturaBanda > nRows) alturaBanda = nRows;
+
+    // Aloca apenas as linhas de uma banda, reutilizadas em todas as bandas
+    char** banda = malloc(alturaBanda * sizeof(char*));
+    if (!banda) {
+        perror("Erro na alocao da banda");
+        return 0;
+    }
+    for (int i = 0; i < alturaBanda; i++) {
+        banda[i] = malloc((nCols + 1) * sizeof(char));
+        if (!banda[i]) {
+            perror("Erro na alocao de uma linha da banda");
+            libertarMatriz(banda, i);
+            return 0;
+        }
+    }
+
+    for (int linhaInicio = minX; linhaInicio <= maxX; linhaInicio += alturaBanda) {
+        int linhaFim = linhaInicio + alturaBanda - 1;
+        if (linhaFim > maxX) linhaFim = maxX;
+
+        preencherBanda(mapa, banda, linhaInicio, linhaFim, minY, nCols);
+        for (int i = 0; i <= linhaFim - linhaInicio; i++) {
+            fprintf(saida, "%s\n", banda[i]);
+        }
+    }
+
+    libertarMatriz(banda, alturaBanda);
+    return 1;
+}
+
+/// <summary>
+/// L um ficheiro de mapa e escreve no ecr a matriz com nefastos, processando-a por bandas de linhas.
+/// </summary>
+/// <param name="filename">Nome do ficheiro a processar.</param>
+/// <param name="alturaBanda">Nmero de linhas de cada banda.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int imprimirFicheiroEmBandas(const char* filename, int alturaBanda) {
+    MapaFrequencias mapa;
+    inicializarMapaFrequencias(&mapa);
+
+    int ok = carregarMapaFrequencias(filename, &mapa) && imprimirMapaEmBandas(&mapa, alturaBanda, stdout);
+
+    libertarMapaFrequencias(&mapa);
+    return ok;
+}
+
+#pragma endregion
 
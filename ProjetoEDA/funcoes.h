@@ -8,6 +8,7 @@
  *  
  */
 
+#include <stdio.h>
 #include "dados.h"
 
 #pragma region Funes da Lista de Antenas
@@ -34,3 +35,18 @@ void libertarMatriz(char** matriz, int nRows);
 #pragma region Funes de Carregamento de Ficheiros
 Antena* carregarAntenasDeFicheiro(const char* filename, Antena* listaExistente);
 #pragma endregion
+
+
+#pragma region Funes de Processamento em Bandas
+void inicializarMapaFrequencias(MapaFrequencias* mapa);
+int adicionarCoordenadaGrupo(GrupoFrequencia* grupo, int x, int y);
+int lerMapaFrequencias(FILE* fp, MapaFrequencias* mapa);
+int carregarMapaFrequencias(const char* filename, MapaFrequencias* mapa);
+void libertarMapaFrequencias(MapaFrequencias* mapa);
+int converterAntenasParaMapa(const Antena* lista, MapaFrequencias* mapa);
+int primeiroPontoComLinha(const GrupoFrequencia* grupo, int x);
+void calcularLimitesMapa(const MapaFrequencias* mapa, int* minX, int* maxX, int* minY, int* maxY);
+void preencherBanda(const MapaFrequencias* mapa, char** banda, int linhaInicio, int linhaFim, int minY, int nCols);
+int imprimirMapaEmBandas(const MapaFrequencias* mapa, int alturaBanda, FILE* saida);
+int imprimirFicheiroEmBandas(const char* filename, int alturaBanda);
+#pragma endregion
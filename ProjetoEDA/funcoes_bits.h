@@ -0,0 +1,36 @@
+/*
+ *  @file funcoes_bits.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-08-11
+ *  @project EDA
+ *
+ *  Funes auxiliares sobre palavras de 64 bits, partilhadas pelos mdulos que percorrem
+ *  mapas de bits (raster compacto e distncias com vrias origens).
+ */
+
+#ifndef FUNCOES_BITS_H
+#define FUNCOES_BITS_H
+
+#include <stdint.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/// <summary>
+/// Devolve a posio do bit a 1 menos significativo de uma palavra (que no pode ser zero).
+/// </summary>
+static inline int bitMenosSignificativo(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long bit;
+    _BitScanForward64(&bit, bits);
+    return (int)bit;
+#else
+    int bit = 0;
+    while (((bits >> bit) & 1) == 0) bit++;
+    return bit;
+#endif
+}
+
+#endif // FUNCOES_BITS_H
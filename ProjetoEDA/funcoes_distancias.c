@@ -0,0 +1,178 @@
+﻿/*
+ *  @file funcoes_distancias.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-14
+ *  @project EDA
+ *
+ *  Implementação do cálculo das distâncias em saltos entre todos os vértices do grafo.
+ *  Em vez de uma BFS por vértice, são feitas procuras com 64 origens ao mesmo tempo: cada vértice
+ *  tem uma palavra de 64 bits em que o bit i indica que a origem i já lá chegou, e cada nível
+ *  da procura é uma única passagem pelas adjacências (em vetores contínuos) com operações OR.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "funcoes_bits.h"
+#include "funcoes_distancias.h"
+
+/// <summary>
+/// Copia as listas de adjacentes do grafo para vetores contínuos (as de v entre inicio[v] e inicio[v + 1]).
+/// </summary>
+static bool criarAdjacenciasContinuas(Grafo* g, int** inicio, int** destinos) {
+    int n = g->tamanho;
+    int total = 0;
+    for (int v = 0; v < n; v++) {
+        for (Adjacente* adj = g->vertices[v].adjacentes; adj != NULL; adj = adj->seguinte) total++;
+    }
+
+    *inicio = malloc((n + 1) * sizeof(int));
+    *destinos = malloc((total + 1) * sizeof(int));
+    if (*inicio == NULL || *destinos == NULL) {
+        free(*inicio);
+        free(*destinos);
+        return false;
+    }
+
+    int k = 0;
+    for (int v = 0; v < n; v++) {
+        (*inicio)[v] = k;
+        for (Adjacente* adj = g->vertices[v].adjacentes; adj != NULL; adj = adj->seguinte) {
+            (*destinos)[k++] = adj->destino;
+        }
+    }
+    (*inicio)[n] = k;
+    return true;
+}
+
+/// <summary>
+/// Calcula as distâncias em saltos a partir de todos os vértices do grafo, 64 origens de cada vez.
+/// Em cada nível, os vértices da fronteira propagam as suas palavras de bits para os adjacentes
+/// e os bits novos (origens que chegam pela primeira vez a um vértice) dão a distância desse nível.
+/// O custo é O(n/64 * D * (V + E)) operações de palavra, sendo D o diâmetro.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="m">Estrutura onde são guardados os resultados.</param>
+/// <param name="guardarMatriz">Se falso, calcula apenas as excentricidades e o diâmetro (sem a matriz n x n).</param>
+/// <returns>True em caso de sucesso; false em caso de erro de alocação.</returns>
+bool calcularDistanciasGrafo(Grafo* g, MatrizDistancias* m, bool guardarMatriz) {
+    int n = g->tamanho;
+    int* inicio;
+    int* destinos;
+
+    memset(m, 0, sizeof(MatrizDistancias));
+    m->tamanho = n;
+    if (!criarAdjacenciasContinuas(g, &inicio, &destinos)) return false;
+
+    uint64_t* visitado = malloc((n + 1) * sizeof(uint64_t));
+    uint64_t* fronteira = malloc((n + 1) * sizeof(uint64_t));
+    uint64_t* proxima = malloc((n + 1) * sizeof(uint64_t));
+    m->excentricidade = calloc(n + 1, sizeof(int));
+    if (guardarMatriz) m->distancias = malloc(((size_t)n * n + 1) * sizeof(int));
+    if (!visitado || !fronteira || !proxima || !m->excentricidade || (guardarMatriz && !m->distancias)) {
+        free(visitado);
+        free(fronteira);
+        free(proxima);
+        free(inicio);
+        free(destinos);
+        libertarMatrizDistancias(m);
+        return false;
+    }
+    if (guardarMatriz) {
+        for (size_t i = 0; i < (size_t)n * n; i++) m->distancias[i] = -1;
+    }
+
+    for (int base = 0; base < n; base += 64) {
+        int origens = n - base < 64 ? n - base : 64;
+
+        // Cada origem começa na fronteira, à distância 0 de si própria
+        memset(visitado, 0, n * sizeof(uint64_t));
+        memset(fronteira, 0, n * sizeof(uint64_t));
+        for (int i = 0; i < origens; i++) {
+            visitado[base + i] = fronteira[base + i] = (uint64_t)1 << i;
+            if (guardarMatriz) m->distancias[(size_t)(base + i) * n + base + i] = 0;
+        }
+
+        for (int nivel = 1; ; nivel++) {
+            memset(proxima, 0, n * sizeof(uint64_t));
+            for (int u = 0; u < n; u++) {
+                if (fronteira[u] == 0) continue;
+                for (int k = inicio[u]; k < inicio[u + 1]; k++) proxima[destinos[k]] |= fronteira[u];
+            }
+
+            // Mantém apenas as origens que chegam pela primeira vez a cada vértice
+            uint64_t chegaram = 0;
+            for (int v = 0; v < n; v++) {
+                proxima[v] &= ~visitado[v];
+                if (proxima[v] == 0) continue;
+                visitado[v] |= proxima[v];
+                chegaram |= proxima[v];
+                if (guardarMatriz) {
+                    for (uint64_t bits = proxima[v]; bits != 0; bits &= bits - 1) {
+                        m->distancias[(size_t)(base + bitMenosSignificativo(bits)) * n + v] = nivel;
+                    }
+                }
+            }
+            if (chegaram == 0) break;
+
+            // As origens que ainda chegaram a algum vértice têm excentricidade pelo menos igual ao nível
+            for (uint64_t bits = chegaram; bits != 0; bits &= bits - 1) {
+                m->excentricidade[base + bitMenosSignificativo(bits)] = nivel;
+            }
+
+            uint64_t* temp = fronteira;
+            fronteira = proxima;
+            proxima = temp;
+        }
+    }
+
+    for (int v = 0; v < n; v++) {
+        if (m->excentricidade[v] > m->diametro) m->diametro = m->excentricidade[v];
+    }
+
+    free(visitado);
+    free(fronteira);
+    free(proxima);
+    free(inicio);
+    free(destinos);
+    return true;
+}
+
+/// <summary>
+/// Liberta a memória ocupada pelos resultados das distâncias.
+/// </summary>
+/// <param name="m">Resultados a libertar.</param>
+void libertarMatrizDistancias(MatrizDistancias* m) {
+    free(m->distancias);
+    free(m->excentricidade);
+    m->distancias = NULL;
+    m->excentricidade = NULL;
+    m->tamanho = 0;
+    m->diametro = 0;
+}
+
+/// <summary>
+/// Devolve a distância em saltos entre dois vértices.
+/// </summary>
+/// <param name="m">Resultados calculados com a matriz.</param>
+/// <param name="origem">Índice do vértice de origem.</param>
+/// <param name="destino">Índice do vértice de destino.</param>
+/// <returns>Número de saltos, ou -1 se não houver caminho, se os índices forem inválidos ou se a matriz não foi guardada.</returns>
+int distanciaSaltos(const MatrizDistancias* m, int origem, int destino) {
+    if (m->distancias == NULL || origem < 0 || origem >= m->tamanho || destino < 0 || destino >= m->tamanho)
+        return -1;
+    return m->distancias[(size_t)origem * m->tamanho + destino];
+}
+
+/// <summary>
+/// Lista a excentricidade de cada vértice (maior distância a um vértice alcançável) e o diâmetro do grafo.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="m">Resultados calculados para o mesmo grafo.</param>
+void listarExcentricidades(Grafo* g, const MatrizDistancias* m) {
+    printf("\nExcentricidades (em saltos):\n");
+    for (int v = 0; v < m->tamanho; v++) {
+        printf("  [%d] %c (%d, %d): %d\n", v, g->vertices[v].freq, g->vertices[v].x, g->vertices[v].y, m->excentricidade[v]);
+    }
+    printf("Diametro: %d\n", m->diametro);
+}
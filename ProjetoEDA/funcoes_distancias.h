@@ -0,0 +1,25 @@
+/*
+ *  @file funcoes_distancias.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-14
+ *  @project EDA
+ *
+ *  Declarao das funes de clculo das distncias em saltos entre todos os vrtices do grafo
+ *  (procura em largura com 64 origens em simultneo).
+ */
+
+#ifndef FUNCOES_DISTANCIAS_H
+#define FUNCOES_DISTANCIAS_H
+
+#include <stdbool.h>
+#include "dados.h"
+
+// Clculo e libertao
+bool calcularDistanciasGrafo(Grafo* g, MatrizDistancias* m, bool guardarMatriz);
+void libertarMatrizDistancias(MatrizDistancias* m);
+
+// Consultas e listagens
+int distanciaSaltos(const MatrizDistancias* m, int origem, int destino);
+void listarExcentricidades(Grafo* g, const MatrizDistancias* m);
+
+#endif // FUNCOES_DISTANCIAS_H
@@ -14,10 +14,70 @@
 #include "funcoes_grafos.h"
 
  /// <summary>
- /// Inicializa a estrutura do grafo, definindo o tamanho como zero.
+ /// Inicializa a estrutura do grafo, definindo o tamanho como zero
+ /// e deixando vazios os índices por frequência e por coordenadas.
  /// </summary>
 void inicializarGrafo(Grafo* g) {
     g->tamanho = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        g->inicioFreq[f] = -1;
+        g->totalFreq[f] = 0;
+    }
+    for (int i = 0; i < TAM_TABELA_COORD; i++) {
+        g->tabelaCoord[i] = -1;
+    }
+}
+
+/// <summary>
+/// Calcula a posição de um par de coordenadas na tabela de dispersão do grafo.
+/// </summary>
+static int posicaoCoordenadas(int x, int y) {
+    unsigned int h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u;
+    return (int)(h % TAM_TABELA_COORD);
+}
+
+/// <summary>
+/// Regista o vértice indicado na lista da sua frequência e na tabela de coordenadas.
+/// </summary>
+static void registarIndices(Grafo* g, int indice) {
+    Vertice* v = &g->vertices[indice];
+    unsigned char f = (unsigned char)v->freq;
+
+    // Insere no início da lista de vértices da mesma frequência
+    v->anteriorFreq = -1;
+    v->seguinteFreq = g->inicioFreq[f];
+    if (g->inicioFreq[f] != -1)
+        g->vertices[g->inicioFreq[f]].anteriorFreq = indice;
+    g->inicioFreq[f] = indice;
+    g->totalFreq[f]++;
+
+    // Insere no início da cadeia da tabela de coordenadas
+    int pos = posicaoCoordenadas(v->x, v->y);
+    v->seguinteCoord = g->tabelaCoord[pos];
+    g->tabelaCoord[pos] = indice;
+}
+
+/// <summary>
+/// Retira o vértice indicado da lista da sua frequência e da tabela de coordenadas.
+/// </summary>
+static void retirarIndices(Grafo* g, int indice) {
+    Vertice* v = &g->vertices[indice];
+    unsigned char f = (unsigned char)v->freq;
+
+    if (v->anteriorFreq != -1)
+        g->vertices[v->anteriorFreq].seguinteFreq = v->seguinteFreq;
+    else
+        g->inicioFreq[f] = v->seguinteFreq;
+    if (v->seguinteFreq != -1)
+        g->vertices[v->seguinteFreq].anteriorFreq = v->anteriorFreq;
+    g->totalFreq[f]--;
+
+    int* ligacao = &g->tabelaCoord[posicaoCoordenadas(v->x, v->y)];
+    while (*ligacao != -1 && *ligacao != indice) {
+        ligacao = &g->vertices[*ligacao].seguinteCoord;
+    }
+    if (*ligacao == indice)
+        *ligacao = v->seguinteCoord;
 }
 
 /// <summary>
@@ -29,19 +89,65 @@ void inicializarGrafo(Grafo* g) {
 /// <param name="y">Coordenada Y.</param>
 /// <returns>Índice do vértice inserido ou -1 em caso de erro.</returns>
 bool inserirVertice(Grafo* g, char freq, int x, int y) {
-    if (g->tamanho >= 1000) return false;
+    if (g->tamanho >= MAX_VERTICES) return false;
 
     g->vertices[g->tamanho].freq = freq;
     g->vertices[g->tamanho].x = x;
     g->vertices[g->tamanho].y = y;
     g->vertices[g->tamanho].adjacentes = NULL;
+    g->vertices[g->tamanho].ultimoAdjacente = NULL;
+    registarIndices(g, g->tamanho);
 
     g->tamanho++;
     return true;
 }
 
+/// <summary>
+/// Coloca uma aresta na lista de adjacentes de um vértice, mantendo a ordem crescente de destinos
+/// (se a lista já estiver ordenada, o que deixa de acontecer depois de removerAntenaGrafo).
+/// Os casos mais comuns (destino menor que o primeiro ou maior que o último) são tratados em O(1).
+/// </summary>
+static void colocarAresta(Vertice* v, Adjacente* novo) {
+    Adjacente* seguinte = v->adjacentes;
+
+    if (v->ultimoAdjacente != NULL && v->ultimoAdjacente->destino < novo->destino) {
+        seguinte = NULL;
+    }
+    else {
+        while (seguinte != NULL && seguinte->destino < novo->destino) {
+            seguinte = seguinte->seguinte;
+        }
+    }
+
+    novo->seguinte = seguinte;
+    novo->anterior = (seguinte != NULL) ? seguinte->anterior : v->ultimoAdjacente;
+    if (novo->anterior != NULL)
+        novo->anterior->seguinte = novo;
+    else
+        v->adjacentes = novo;
+    if (seguinte != NULL)
+        seguinte->anterior = novo;
+    else
+        v->ultimoAdjacente = novo;
+}
+
+/// <summary>
+/// Retira uma aresta da lista de adjacentes de um vértice, sem a libertar.
+/// </summary>
+static void retirarAresta(Vertice* v, Adjacente* aresta) {
+    if (aresta->anterior != NULL)
+        aresta->anterior->seguinte = aresta->seguinte;
+    else
+        v->adjacentes = aresta->seguinte;
+    if (aresta->seguinte != NULL)
+        aresta->seguinte->anterior = aresta->anterior;
+    else
+        v->ultimoAdjacente = aresta->anterior;
+}
+
 /// <summary>
 /// Insere uma ligação (aresta) entre dois vértices do grafo.
+/// Se já existir a aresta no sentido contrário, ambas ficam associadas como inversas.
 /// </summary>
 /// <param name="g">Ponteiro para o grafo.</param>
 /// <param name="origem">Índice do vértice de origem.</param>
@@ -51,37 +157,171 @@ bool inserirAresta(Grafo* g, int origem, int destino) {
     if (!novo) return false;
 
     novo->destino = destino;
-    novo->seguinte = NULL;
+    novo->inversa = NULL;
+    colocarAresta(&g->vertices[origem], novo);
+
+    for (Adjacente* inv = g->vertices[destino].adjacentes; inv != NULL; inv = inv->seguinte) {
+        if (inv->destino == origem && inv->inversa == NULL) {
+            inv->inversa = novo;
+            novo->inversa = inv;
+            break;
+        }
+    }
 
-    Adjacente** atual = &g->vertices[origem].adjacentes;
+    return true;
+}
 
-    while (*atual != NULL && (*atual)->destino < destino) {
-        atual = &(*atual)->seguinte;
+/// <summary>
+/// Liga dois vértices nos dois sentidos, associando diretamente as duas arestas como inversas.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="a">Índice do primeiro vértice.</param>
+/// <param name="b">Índice do segundo vértice.</param>
+/// <returns>True se as duas arestas foram criadas; caso contrário, false.</returns>
+static bool ligarVertices(Grafo* g, int a, int b) {
+    Adjacente* ab = (Adjacente*)malloc(sizeof(Adjacente));
+    Adjacente* ba = (Adjacente*)malloc(sizeof(Adjacente));
+    if (!ab || !ba) {
+        free(ab);
+        free(ba);
+        return false;
     }
 
-    novo->seguinte = *atual;
-    *atual = novo;
-
+    ab->destino = b;
+    ba->destino = a;
+    ab->inversa = ba;
+    ba->inversa = ab;
+    colocarAresta(&g->vertices[a], ab);
+    colocarAresta(&g->vertices[b], ba);
     return true;
 }
 
+/// <summary>
+/// Liberta todas as arestas de um vértice, deixando a sua lista de adjacentes vazia.
+/// </summary>
+static void libertarArestasVertice(Vertice* v) {
+    Adjacente* adj = v->adjacentes;
+    while (adj != NULL) {
+        Adjacente* temp = adj;
+        adj = adj->seguinte;
+        free(temp);
+    }
+    v->adjacentes = NULL;
+    v->ultimoAdjacente = NULL;
+}
 
 /// <summary>
 /// Cria arestas entre antenas com a mesma frequência no grafo.
 /// Deve ser chamada após todos os vértices estarem inseridos.
+/// As arestas existentes são descartadas antes, para não haver ligações duplicadas.
 /// </summary>
 /// <param name="g">Ponteiro para o grafo.</param>
 void criarArestasPorFrequencia(Grafo* g) {
+    for (int i = 0; i < g->tamanho; i++) {
+        libertarArestasVertice(&g->vertices[i]);
+    }
+
     for (int i = 0; i < g->tamanho; i++) {
         for (int j = i + 1; j < g->tamanho; j++) {
             if (g->vertices[i].freq == g->vertices[j].freq) {
-                inserirAresta(g, i, j);
-                inserirAresta(g, j, i);
+                ligarVertices(g, i, j);
             }
         }
     }
 }
 
+/// <summary>
+/// Adiciona uma antena a um grafo já construído, ligando-a apenas às antenas da mesma frequência.
+/// Ao contrário de inserirVertice seguido de criarArestasPorFrequencia, não percorre
+/// todos os pares do grafo: o custo é proporcional ao tamanho do grupo da frequência.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="freq">Frequência da antena.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>Índice do novo vértice ou -1 se já existir antena nessas coordenadas, o grafo estiver cheio
+/// ou faltar memória para as ligações (neste caso a antena não fica no grafo).</returns>
+int adicionarAntenaGrafo(Grafo* g, char freq, int x, int y) {
+    if (encontrarIndicePorCoordenadas(g, x, y) != -1) return -1;
+    if (!inserirVertice(g, freq, x, y)) return -1;
+
+    int novo = g->tamanho - 1;
+    for (int u = g->vertices[novo].seguinteFreq; u != -1; u = g->vertices[u].seguinteFreq) {
+        if (!ligarVertices(g, u, novo)) {
+            // Desfaz as ligações já criadas, para não deixar a antena ligada apenas a parte do grupo
+            printf("Erro ao ligar a antena (%d, %d).\n", x, y);
+            removerAntenaGrafo(g, x, y);
+            return -1;
+        }
+    }
+    return novo;
+}
+
+/// <summary>
+/// Remove do grafo a antena com as coordenadas indicadas, desligando-a apenas do seu grupo de frequência.
+/// Para manter os índices compactos, o último vértice passa a ocupar a posição libertada
+/// e as referências a esse vértice (arestas inversas e índices) são atualizadas.
+/// As arestas inversas ficam na mesma posição das listas dos vizinhos, com o destino alterado,
+/// pelo que depois de uma remoção essas listas deixam de estar por ordem crescente de destinos.
+/// Assume que as arestas são simétricas, como as criadas por criarArestasPorFrequencia.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="x">Coordenada X da antena a remover.</param>
+/// <param name="y">Coordenada Y da antena a remover.</param>
+/// <returns>True se a antena foi removida; false se não existir.</returns>
+bool removerAntenaGrafo(Grafo* g, int x, int y) {
+    int indice = encontrarIndicePorCoordenadas(g, x, y);
+    if (indice == -1) return false;
+
+    // Retira as arestas inversas das listas dos vizinhos e liberta as próprias
+    for (Adjacente* adj = g->vertices[indice].adjacentes; adj != NULL; adj = adj->seguinte) {
+        if (adj->inversa != NULL) {
+            retirarAresta(&g->vertices[adj->destino], adj->inversa);
+            free(adj->inversa);
+        }
+    }
+    libertarArestasVertice(&g->vertices[indice]);
+    retirarIndices(g, indice);
+
+    int ultimo = g->tamanho - 1;
+    if (indice != ultimo) {
+        // O último vértice passa para a posição libertada
+        g->vertices[indice] = g->vertices[ultimo];
+        Vertice* v = &g->vertices[indice];
+
+        for (Adjacente* adj = v->adjacentes; adj != NULL; adj = adj->seguinte) {
+            if (adj->inversa != NULL) adj->inversa->destino = indice;
+        }
+
+        if (v->anteriorFreq != -1)
+            g->vertices[v->anteriorFreq].seguinteFreq = indice;
+        else
+            g->inicioFreq[(unsigned char)v->freq] = indice;
+        if (v->seguinteFreq != -1)
+            g->vertices[v->seguinteFreq].anteriorFreq = indice;
+
+        int* ligacao = &g->tabelaCoord[posicaoCoordenadas(v->x, v->y)];
+        while (*ligacao != ultimo) {
+            ligacao = &g->vertices[*ligacao].seguinteCoord;
+        }
+        *ligacao = indice;
+    }
+
+    g->tamanho--;
+    return true;
+}
+
+/// <summary>
+/// Liberta todas as arestas do grafo e volta a deixá-lo vazio.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+void libertarGrafo(Grafo* g) {
+    for (int i = 0; i < g->tamanho; i++) {
+        libertarArestasVertice(&g->vertices[i]);
+    }
+    inicializarGrafo(g);
+}
+
 /// <summary>
 /// Carrega os dados das antenas a partir de um ficheiro de texto.
 /// Cada antena lida é adicionada ao grafo como vértice.
@@ -171,7 +411,7 @@ void listarArestasGrafo(Grafo g) {
 /// <param name="y">Coordenada Y da antena.</param>
 /// <returns>Índice do vértice ou -1 se não existir.</returns>
 int encontrarIndicePorCoordenadas(Grafo* g, int x, int y) {
-    for (int i = 0; i < g->tamanho; i++) {
+    for (int i = g->tabelaCoord[posicaoCoordenadas(x, y)]; i != -1; i = g->vertices[i].seguinteCoord) {
         if (g->vertices[i].x == x && g->vertices[i].y == y) {
             return i;
         }
@@ -207,7 +447,7 @@ void dfsVisita(Grafo* g, int atual, int* visitado) {
 /// <param name="g">Ponteiro para o grafo.</param>
 /// <param name="indiceOrigem">Índice do vértice de partida.</param>
 void dfs(Grafo* g, int indiceOrigem) {
-    int visitado[1000] = { 0 };
+    int visitado[MAX_VERTICES] = { 0 };
 
     if (indiceOrigem < 0 || indiceOrigem >= g->tamanho) {
         printf("Índice de vertice invalido: %d\n", indiceOrigem);
@@ -231,8 +471,8 @@ void dfs(Grafo* g, int indiceOrigem) {
 /// <param name="g">Ponteiro para o grafo.</param>
 /// <param name="origem">Índice do vértice de origem.</param>
 void bfsVisita(Grafo* g, int origem) {
-    int visitado[1000] = { 0 };
-    int fila[1000];
+    int visitado[MAX_VERTICES] = { 0 };
+    int fila[MAX_VERTICES];
     int inicio = 0, fim = 0;
 
     fila[fim++] = origem;
@@ -275,6 +515,58 @@ void bfs(Grafo* g, int indiceOrigem) {
     bfsVisita(g, indiceOrigem);
 }
 
+/// <summary>
+/// Identifica as componentes ligadas do grafo através de procuras em largura, sem escrever no ecrã.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="componente">Vetor opcional (pode ser NULL) onde é guardada a componente de cada vértice.</param>
+/// <returns>Número de componentes ligadas.</returns>
+int contarComponentesGrafo(Grafo* g, int* componente) {
+    int etiqueta[MAX_VERTICES];
+    int fila[MAX_VERTICES];
+    int total = 0;
+
+    for (int i = 0; i < g->tamanho; i++) etiqueta[i] = -1;
+
+    for (int i = 0; i < g->tamanho; i++) {
+        if (etiqueta[i] != -1) continue;
+
+        int inicio = 0, fim = 0;
+        fila[fim++] = i;
+        etiqueta[i] = total;
+        while (inicio < fim) {
+            int atual = fila[inicio++];
+            for (Adjacente* adj = g->vertices[atual].adjacentes; adj != NULL; adj = adj->seguinte) {
+                if (etiqueta[adj->destino] == -1) {
+                    etiqueta[adj->destino] = total;
+                    fila[fim++] = adj->destino;
+                }
+            }
+        }
+        total++;
+    }
+
+    if (componente != NULL) {
+        for (int i = 0; i < g->tamanho; i++) componente[i] = etiqueta[i];
+    }
+    return total;
+}
+
+/// <summary>
+/// Conta as arestas do grafo, considerando cada ligação nos dois sentidos uma só vez.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <returns>Número de arestas.</returns>
+int contarArestasGrafo(Grafo* g) {
+    int total = 0;
+    for (int i = 0; i < g->tamanho; i++) {
+        for (Adjacente* adj = g->vertices[i].adjacentes; adj != NULL; adj = adj->seguinte) {
+            total++;
+        }
+    }
+    return total / 2;
+}
+
 /// <summary>
 /// Função recursiva auxiliar que identifica todos os caminhos possíveis entre dois vértices do grafo.
 /// A travessia é feita com backtracking, garantindo que não há ciclos e que todos os caminhos válidos são explorados.
@@ -327,8 +619,8 @@ void listarTodosOsCaminhos(Grafo* g, int origem, int destino) {
         return;
     }
 
-    int visitado[1000] = { 0 };
-    int caminho[1000];
+    int visitado[MAX_VERTICES] = { 0 };
+    int caminho[MAX_VERTICES];
 
     printf("\nTodos os caminhos de [%d] %c (%d, %d) para [%d] %c (%d, %d):\n",
         origem, g->vertices[origem].freq, g->vertices[origem].x, g->vertices[origem].y,
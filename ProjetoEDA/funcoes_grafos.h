@@ -19,6 +19,11 @@ bool inserirVertice(Grafo* g, char freq, int x, int y);
 bool inserirAresta(Grafo* g, int origem, int destino);
 void criarArestasPorFrequencia(Grafo* g);
 bool carregarGrafoDeMapa(Grafo* g, const char* ficheiro);
+void libertarGrafo(Grafo* g);
+
+// Atualizaes incrementais
+int adicionarAntenaGrafo(Grafo* g, char freq, int x, int y);
+bool removerAntenaGrafo(Grafo* g, int x, int y);
 
 // Listagens
 void listarVerticesGrafo(Grafo g);
@@ -30,6 +35,8 @@ void dfsVisita(Grafo* g, int origem, int* visitado);
 void dfs(Grafo* g, int indiceOrigem);
 void bfsVisita(Grafo* g, int origem);
 void bfs(Grafo* g, int indiceOrigem);
+int contarComponentesGrafo(Grafo* g, int* componente);
+int contarArestasGrafo(Grafo* g);
 
 // Caminhos
 void caminhosAux(Grafo* g, int atual, int destino, int* visitado, int* caminho, int profundidade);
@@ -0,0 +1,287 @@
+﻿/*
+ *  @file funcoes_interferencia.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-16
+ *  @project EDA
+ *
+ *  Implementação do mapa de interferência. Em vez de reduzir cada simétrico a sim/não (como
+ *  existeNefasto), conta quantos pares de antenas atingem cada célula, no total e por frequência,
+ *  numa única passagem pelos pares. As células mais críticas são obtidas com uma heap mínima.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "funcoes_interferencia.h"
+
+/// <summary>
+/// Calcula a posição inicial de uma célula (e frequência) numa tabela com capacidade potência de 2.
+/// </summary>
+static size_t posicaoInterferencia(int x, int y, char freq, size_t capacidade) {
+    unsigned int h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^ (unsigned char)freq * 83492791u;
+    h ^= h >> 15;
+    return (size_t)h & (capacidade - 1);
+}
+
+/// <summary>
+/// Procura a entrada de uma célula (e frequência) na tabela, por sondagem linear.
+/// Devolve a posição da entrada ou da posição livre onde deveria estar.
+/// </summary>
+static size_t procurarEntrada(const CelulaInterferencia* tabela, size_t capacidade, int x, int y, char freq) {
+    size_t pos = posicaoInterferencia(x, y, freq, capacidade);
+    while (tabela[pos].contagem != 0
+        && (tabela[pos].x != x || tabela[pos].y != y || tabela[pos].freq != freq)) {
+        pos = (pos + 1) & (capacidade - 1);
+    }
+    return pos;
+}
+
+/// <summary>
+/// Duplica a capacidade de uma tabela, voltando a colocar todas as entradas.
+/// </summary>
+static int aumentarTabela(CelulaInterferencia** tabela, size_t* capacidade) {
+    size_t novaCapacidade = *capacidade * 2;
+    CelulaInterferencia* nova = calloc(novaCapacidade, sizeof(CelulaInterferencia));
+    if (!nova) return 0;
+
+    for (size_t i = 0; i < *capacidade; i++) {
+        const CelulaInterferencia* c = &(*tabela)[i];
+        if (c->contagem == 0) continue;
+        nova[procurarEntrada(nova, novaCapacidade, c->x, c->y, c->freq)] = *c;
+    }
+    free(*tabela);
+    *tabela = nova;
+    *capacidade = novaCapacidade;
+    return 1;
+}
+
+/// <summary>
+/// Incrementa a contagem de uma célula (e frequência), criando a entrada se ainda não existir.
+/// A tabela é aumentada quando uma nova entrada a deixaria mais de meio cheia.
+/// </summary>
+static int registarImpacto(CelulaInterferencia** tabela, size_t* capacidade, size_t* total, int x, int y, char freq) {
+    size_t pos = procurarEntrada(*tabela, *capacidade, x, y, freq);
+    if ((*tabela)[pos].contagem == 0) {
+        if (2 * (*total + 1) > *capacidade) {
+            if (!aumentarTabela(tabela, capacidade)) return 0;
+            pos = procurarEntrada(*tabela, *capacidade, x, y, freq);
+        }
+        (*tabela)[pos].x = x;
+        (*tabela)[pos].y = y;
+        (*tabela)[pos].freq = freq;
+        (*total)++;
+    }
+    (*tabela)[pos].contagem++;
+    return 1;
+}
+
+/// <summary>
+/// Calcula a capacidade inicial de uma tabela: potência de 2 com pelo menos o dobro das entradas previstas.
+/// </summary>
+static size_t capacidadeInicial(size_t entradas) {
+    size_t capacidade = 16;
+    while (capacidade < 2 * entradas) capacidade *= 2;
+    return capacidade;
+}
+
+/// <summary>
+/// Cria o mapa de interferência de um mapa de antenas. Cada par de antenas da mesma frequência
+/// atinge os seus dois simétricos; cada impacto incrementa a contagem total da célula e a contagem
+/// da célula para essa frequência, tudo na mesma passagem pelos pares.
+/// As tabelas começam com o menor valor entre o número de impactos e o número de células do mapa
+/// (vezes o número de frequências presentes, na tabela por frequência) e crescem conforme são preenchidas.
+/// </summary>
+/// <param name="mapa">Mapa de frequências com as antenas.</param>
+/// <param name="interferencia">Mapa de interferência a preencher.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int criarMapaInterferencia(const MapaFrequencias* mapa, MapaInterferencia* interferencia) {
+    memset(interferencia, 0, sizeof(MapaInterferencia));
+
+    // O número de impactos é conhecido à partida: g * (g - 1) por frequência
+    size_t impactos = 0, frequencias = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        size_t g = (size_t)mapa->grupos[f].total;
+        if (g > 1) {
+            impactos += g * (g - 1);
+            frequencias++;
+        }
+    }
+    size_t celulasMapa = (size_t)mapa->nLinhas * (size_t)mapa->nColunas;
+    size_t previstasCelulas = impactos, previstasFrequencia = impactos;
+    if (celulasMapa > 0 && previstasCelulas > celulasMapa) previstasCelulas = celulasMapa;
+    if (celulasMapa > 0 && previstasFrequencia > celulasMapa * frequencias) previstasFrequencia = celulasMapa * frequencias;
+
+    interferencia->capacidadeCelulas = capacidadeInicial(previstasCelulas);
+    interferencia->capacidadeFrequencia = capacidadeInicial(previstasFrequencia);
+    interferencia->celulas = calloc(interferencia->capacidadeCelulas, sizeof(CelulaInterferencia));
+    interferencia->porFrequencia = calloc(interferencia->capacidadeFrequencia, sizeof(CelulaInterferencia));
+    if (!interferencia->celulas || !interferencia->porFrequencia) {
+        perror("Erro na alocação do mapa de interferência");
+        libertarMapaInterferencia(interferencia);
+        return 0;
+    }
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            for (int j = i + 1; j < grupo->total; j++) {
+                const Coordenada* p = &grupo->pontos[i];
+                const Coordenada* q = &grupo->pontos[j];
+                int x1 = 2 * q->x - p->x, y1 = 2 * q->y - p->y;
+                int x2 = 2 * p->x - q->x, y2 = 2 * p->y - q->y;
+
+                if (!registarImpacto(&interferencia->celulas, &interferencia->capacidadeCelulas, &interferencia->totalCelulas, x1, y1, 0)
+                    || !registarImpacto(&interferencia->celulas, &interferencia->capacidadeCelulas, &interferencia->totalCelulas, x2, y2, 0)
+                    || !registarImpacto(&interferencia->porFrequencia, &interferencia->capacidadeFrequencia, &interferencia->totalPorFrequencia, x1, y1, (char)f)
+                    || !registarImpacto(&interferencia->porFrequencia, &interferencia->capacidadeFrequencia, &interferencia->totalPorFrequencia, x2, y2, (char)f)) {
+                    perror("Erro na alocação do mapa de interferência");
+                    libertarMapaInterferencia(interferencia);
+                    return 0;
+                }
+            }
+        }
+        interferencia->impactosFrequencia[f] = (long long)grupo->total * (grupo->total - (grupo->total > 0));
+        interferencia->totalImpactos += interferencia->impactosFrequencia[f];
+    }
+
+    return 1;
+}
+
+/// <summary>
+/// Liberta as tabelas do mapa de interferência.
+/// </summary>
+/// <param name="interferencia">Mapa de interferência a libertar.</param>
+void libertarMapaInterferencia(MapaInterferencia* interferencia) {
+    free(interferencia->celulas);
+    free(interferencia->porFrequencia);
+    memset(interferencia, 0, sizeof(MapaInterferencia));
+}
+
+/// <summary>
+/// Devolve quantos pares de antenas atingem uma célula.
+/// </summary>
+/// <param name="interferencia">Mapa de interferência.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>Número de impactos na célula (0 se não for nefasto).</returns>
+int contagemInterferencia(const MapaInterferencia* interferencia, int x, int y) {
+    if (interferencia->capacidadeCelulas == 0) return 0;
+    size_t pos = procurarEntrada(interferencia->celulas, interferencia->capacidadeCelulas, x, y, 0);
+    return interferencia->celulas[pos].contagem;
+}
+
+/// <summary>
+/// Devolve quantos pares de antenas de uma frequência atingem uma célula.
+/// </summary>
+/// <param name="interferencia">Mapa de interferência.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <param name="freq">Frequência das antenas.</param>
+/// <returns>Número de impactos da frequência na célula.</returns>
+int contagemInterferenciaFrequencia(const MapaInterferencia* interferencia, int x, int y, char freq) {
+    if (interferencia->capacidadeFrequencia == 0) return 0;
+    size_t pos = procurarEntrada(interferencia->porFrequencia, interferencia->capacidadeFrequencia, x, y, freq);
+    return interferencia->porFrequencia[pos].contagem;
+}
+
+/// <summary>
+/// Indica se a célula a é menos crítica do que b: menos impactos ou, em caso de empate,
+/// posterior na ordem linha/coluna (para que o resultado seja determinista).
+/// </summary>
+static int menosCritica(const CelulaInterferencia* a, const CelulaInterferencia* b) {
+    if (a->contagem != b->contagem) return a->contagem < b->contagem;
+    if (a->x != b->x) return a->x > b->x;
+    return a->y > b->y;
+}
+
+/// <summary>
+/// Repõe a propriedade da heap mínima a partir da posição indicada, descendo na árvore.
+/// </summary>
+static void descerHeap(CelulaInterferencia* heap, int tamanho, int pos) {
+    for (;;) {
+        int menor = pos;
+        int esq = 2 * pos + 1, dir = 2 * pos + 2;
+        if (esq < tamanho && menosCritica(&heap[esq], &heap[menor])) menor = esq;
+        if (dir < tamanho && menosCritica(&heap[dir], &heap[menor])) menor = dir;
+        if (menor == pos) return;
+
+        CelulaInterferencia temp = heap[pos];
+        heap[pos] = heap[menor];
+        heap[menor] = temp;
+        pos = menor;
+    }
+}
+
+/// <summary>
+/// Obtém as k células mais atingidas, por ordem decrescente de impactos.
+/// Mantém uma heap mínima com as k melhores células vistas até ao momento, pelo que percorre
+/// a tabela uma única vez em O(n log k).
+/// </summary>
+/// <param name="interferencia">Mapa de interferência.</param>
+/// <param name="k">Número de células pretendidas.</param>
+/// <param name="resultado">Vetor com pelo menos k posições, onde são guardadas as células.</param>
+/// <returns>Número de células devolvidas (pode ser inferior a k).</returns>
+int celulasMaisCriticas(const MapaInterferencia* interferencia, int k, CelulaInterferencia* resultado) {
+    int tamanho = 0;
+    if (k <= 0) return 0;
+
+    for (size_t i = 0; i < interferencia->capacidadeCelulas; i++) {
+        const CelulaInterferencia* c = &interferencia->celulas[i];
+        if (c->contagem == 0) continue;
+
+        if (tamanho < k) {
+            // Insere no fim e sobe até à posição correta
+            int pos = tamanho++;
+            resultado[pos] = *c;
+            while (pos > 0 && menosCritica(&resultado[pos], &resultado[(pos - 1) / 2])) {
+                CelulaInterferencia temp = resultado[pos];
+                resultado[pos] = resultado[(pos - 1) / 2];
+                resultado[(pos - 1) / 2] = temp;
+                pos = (pos - 1) / 2;
+            }
+        }
+        else if (menosCritica(&resultado[0], c)) {
+            resultado[0] = *c;
+            descerHeap(resultado, tamanho, 0);
+        }
+    }
+
+    // Retira sucessivamente a menos crítica para o fim, ficando o vetor por ordem decrescente
+    for (int fim = tamanho - 1; fim > 0; fim--) {
+        CelulaInterferencia temp = resultado[0];
+        resultado[0] = resultado[fim];
+        resultado[fim] = temp;
+        descerHeap(resultado, fim, 0);
+    }
+    return tamanho;
+}
+
+/// <summary>
+/// Lista as k células mais atingidas, com a contagem total e a contribuição de cada frequência.
+/// </summary>
+/// <param name="interferencia">Mapa de interferência.</param>
+/// <param name="k">Número de células a listar.</param>
+void listarCelulasMaisCriticas(const MapaInterferencia* interferencia, int k) {
+    if (k <= 0) return;
+    CelulaInterferencia* criticas = malloc(k * sizeof(CelulaInterferencia));
+    if (!criticas) {
+        perror("Erro na alocação das células críticas");
+        return;
+    }
+
+    int n = celulasMaisCriticas(interferencia, k, criticas);
+    printf("\nCelulas mais criticas (%d de %zu celulas nefastas):\n", n, interferencia->totalCelulas);
+    printf("X | Y | Impactos | Por frequencia\n");
+    printf("----------------------------------\n");
+    for (int i = 0; i < n; i++) {
+        printf(" %d | %d | %d |", criticas[i].x, criticas[i].y, criticas[i].contagem);
+        for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+            if (interferencia->impactosFrequencia[f] == 0) continue;
+            int c = contagemInterferenciaFrequencia(interferencia, criticas[i].x, criticas[i].y, (char)f);
+            if (c > 0) printf(" %c:%d", (char)f, c);
+        }
+        printf("\n");
+    }
+
+    free(criticas);
+}
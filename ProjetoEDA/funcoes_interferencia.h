@@ -0,0 +1,28 @@
+/*
+ *  @file funcoes_interferencia.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-16
+ *  @project EDA
+ *
+ *  Declarao das funes do mapa de interferncia (nmero de pares de antenas
+ *  que atingem cada clula) e da consulta das clulas mais crticas.
+ */
+
+#ifndef FUNCOES_INTERFERENCIA_H
+#define FUNCOES_INTERFERENCIA_H
+
+#include "dados.h"
+
+// Criao e libertao
+int criarMapaInterferencia(const MapaFrequencias* mapa, MapaInterferencia* interferencia);
+void libertarMapaInterferencia(MapaInterferencia* interferencia);
+
+// Consultas
+int contagemInterferencia(const MapaInterferencia* interferencia, int x, int y);
+int contagemInterferenciaFrequencia(const MapaInterferencia* interferencia, int x, int y, char freq);
+int celulasMaisCriticas(const MapaInterferencia* interferencia, int k, CelulaInterferencia* resultado);
+
+// Listagens
+void listarCelulasMaisCriticas(const MapaInterferencia* interferencia, int k);
+
+#endif // FUNCOES_INTERFERENCIA_H
@@ -0,0 +1,260 @@
+﻿/*
+ *  @file funcoes_leitura.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-08-04
+ *  @project EDA
+ *
+ *  Implementação da leitura de ficheiros de mapa em paralelo. O ficheiro é lido para memória
+ *  e dividido em blocos que terminam sempre numa quebra de linha. Cada thread lê o seu bloco
+ *  com linhas numeradas a partir de 0 e guarda as antenas em grupos por frequência próprios;
+ *  a soma acumulada das linhas de cada bloco dá a primeira linha real de cada um, e a soma
+ *  acumulada dos totais por frequência dá a posição onde cada thread copia os seus pontos.
+ *  Como as posições são disjuntas, a junção não precisa de trincos, e a ordem final é a mesma
+ *  de lerMapaFrequencias (por linha e depois por coluna, em cada frequência).
+ */
+
+// fseeko/ftello com posições de 64 bits, também em sistemas de 32 bits (tem de vir antes dos includes)
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+#include "funcoes.h"
+#include "funcoes_leitura.h"
+
+// No MSVC, long tem 32 bits: fseek/ftell não chegam para ficheiros de 2 GB ou mais
+#ifdef _WIN32
+#define procurarFicheiro _fseeki64
+#define posicaoFicheiro _ftelli64
+#else
+#include <sys/types.h>
+#define procurarFicheiro fseeko
+#define posicaoFicheiro ftello
+#endif
+
+#define MAX_THREADS_LEITURA 16
+#define TAMANHO_MINIMO_BLOCO (1 << 16)   // Blocos mais pequenos não compensam criar uma thread
+
+/// <summary>
+/// Bloco do ficheiro lido por uma thread: o intervalo de bytes, as antenas encontradas
+/// (com a linha relativa ao início do bloco) e a posição onde são copiadas no mapa final.
+/// </summary>
+typedef struct {
+    const char* inicio;
+    const char* fim;
+    MapaFrequencias local;             // Antenas do bloco, com x a começar em 0
+    int linhas;                        // Número de linhas do bloco
+    int linhaInicial;                  // Linha real (a começar em 1) da primeira linha do bloco
+    int destino[NUM_FREQUENCIAS];      // Posição da primeira antena do bloco em cada grupo do mapa
+    MapaFrequencias* mapa;
+    int sucesso;
+} BlocoLeitura;
+
+/// <summary>
+/// Lê um bloco carácter a carácter, com as mesmas regras de lerMapaFrequencias.
+/// </summary>
+static int lerBloco(void* arg) {
+    BlocoLeitura* bloco = (BlocoLeitura*)arg;
+    MapaFrequencias* local = &bloco->local;
+    int x = 0, y = 1;
+
+    for (const char* p = bloco->inicio; p < bloco->fim; p++) {
+        char c = *p;
+        if (c == '\n') {
+            if (y - 1 > local->nColunas) local->nColunas = y - 1;
+            x++;
+            y = 1;
+            continue;
+        }
+        if (c == '\r') continue;
+
+        if (c != '.' && c != ' ') {
+            if (!adicionarCoordenadaGrupo(&local->grupos[(unsigned char)c], x, y)) {
+                bloco->sucesso = 0;
+                return 0;
+            }
+            local->totalAntenas++;
+        }
+        y++;
+    }
+    // Só o último bloco pode terminar numa linha sem quebra de linha
+    if (y > 1) {
+        if (y - 1 > local->nColunas) local->nColunas = y - 1;
+        x++;
+    }
+    bloco->linhas = x;
+    bloco->sucesso = 1;
+    return 0;
+}
+
+/// <summary>
+/// Copia as antenas de um bloco para as posições reservadas no mapa final, acertando a linha.
+/// </summary>
+static int juntarBloco(void* arg) {
+    BlocoLeitura* bloco = (BlocoLeitura*)arg;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* origem = &bloco->local.grupos[f];
+        Coordenada* destino = bloco->mapa->grupos[f].pontos + bloco->destino[f];
+        for (int i = 0; i < origem->total; i++) {
+            destino[i].x = origem->pontos[i].x + bloco->linhaInicial;
+            destino[i].y = origem->pontos[i].y;
+        }
+    }
+    return 0;
+}
+
+/// <summary>
+/// Executa uma função sobre todos os blocos: o primeiro na thread atual e os restantes em threads novas.
+/// Se não for possível criar uma thread, o bloco é tratado na thread atual.
+/// </summary>
+static void executarBlocos(BlocoLeitura* blocos, int total, thrd_start_t funcao) {
+    thrd_t threads[MAX_THREADS_LEITURA];
+    int criada[MAX_THREADS_LEITURA] = { 0 };
+
+    for (int i = 1; i < total; i++) {
+        criada[i] = thrd_create(&threads[i], funcao, &blocos[i]) == thrd_success;
+    }
+    for (int i = 0; i < total; i++) {
+        if (!criada[i]) funcao(&blocos[i]);
+    }
+    for (int i = 1; i < total; i++) {
+        if (criada[i]) thrd_join(threads[i], NULL);
+    }
+}
+
+/// <summary>
+/// Lê um ficheiro inteiro para memória.
+/// </summary>
+static char* lerFicheiroCompleto(const char* filename, size_t* tamanho) {
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        perror("Erro ao abrir ficheiro");
+        return NULL;
+    }
+
+    char* dados = NULL;
+    size_t comprimento = 0;
+    long long fim = -1;
+    if (procurarFicheiro(fp, 0, SEEK_END) == 0) fim = (long long)posicaoFicheiro(fp);
+    // O tamanho tem de caber em size_t (e ainda sobrar um byte) para o ficheiro ser lido para memória
+    if (fim >= 0 && (unsigned long long)fim < SIZE_MAX && procurarFicheiro(fp, 0, SEEK_SET) == 0) {
+        comprimento = (size_t)fim;
+        dados = malloc(comprimento + 1);
+        if (dados && fread(dados, 1, comprimento, fp) != comprimento) {
+            free(dados);
+            dados = NULL;
+        }
+    }
+    if (!dados) perror("Erro ao ler o ficheiro");
+
+    fclose(fp);
+    *tamanho = dados ? comprimento : 0;
+    return dados;
+}
+
+/// <summary>
+/// Carrega um ficheiro de mapa para um mapa de frequências com várias threads.
+/// O resultado é igual ao de carregarMapaFrequencias, incluindo a ordem dos pontos de cada grupo.
+/// </summary>
+/// <param name="filename">Nome do ficheiro a carregar.</param>
+/// <param name="mapa">Mapa de frequências (inicializado) onde são guardadas as antenas.</param>
+/// <param name="numThreads">Número máximo de threads (os ficheiros pequenos usam menos).</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int carregarMapaFrequenciasParalelo(const char* filename, MapaFrequencias* mapa, int numThreads) {
+    size_t tamanho;
+    char* dados = lerFicheiroCompleto(filename, &tamanho);
+    if (!dados) return 0;
+
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS_LEITURA) numThreads = MAX_THREADS_LEITURA;
+    if ((size_t)numThreads > tamanho / TAMANHO_MINIMO_BLOCO + 1) numThreads = (int)(tamanho / TAMANHO_MINIMO_BLOCO + 1);
+
+    BlocoLeitura* blocos = malloc(numThreads * sizeof(BlocoLeitura));
+    if (!blocos) {
+        perror("Erro na alocação dos blocos de leitura");
+        free(dados);
+        return 0;
+    }
+
+    // Divide o ficheiro em partes aproximadamente iguais, acabando cada uma depois de uma quebra de linha
+    const char* fimDados = dados + tamanho;
+    const char* inicio = dados;
+    int total = 0;
+    for (int i = 0; i < numThreads && inicio < fimDados; i++) {
+        const char* fim = fimDados;
+        if (i < numThreads - 1) {
+            const char* nominal = dados + tamanho / numThreads * (i + 1);
+            if (nominal < inicio) nominal = inicio;
+            const char* quebra = memchr(nominal, '\n', fimDados - nominal);
+            if (quebra) fim = quebra + 1;
+        }
+        blocos[total].inicio = inicio;
+        blocos[total].fim = fim;
+        blocos[total].mapa = mapa;
+        inicializarMapaFrequencias(&blocos[total].local);
+        total++;
+        inicio = fim;
+    }
+
+    executarBlocos(blocos, total, lerBloco);
+
+    int sucesso = 1;
+    for (int i = 0; i < total; i++) {
+        if (!blocos[i].sucesso) sucesso = 0;
+    }
+
+    // Reserva o espaço de cada grupo; os totais do mapa só mudam se todas as reservas tiverem sucesso
+    for (int f = 0; f < NUM_FREQUENCIAS && sucesso; f++) {
+        GrupoFrequencia* grupo = &mapa->grupos[f];
+        int novoTotal = grupo->total;
+        for (int i = 0; i < total; i++) {
+            novoTotal += blocos[i].local.grupos[f].total;
+        }
+        if (novoTotal > grupo->capacidade) {
+            Coordenada* novos = realloc(grupo->pontos, novoTotal * sizeof(Coordenada));
+            if (!novos) {
+                perror("Erro na alocação do mapa de frequências");
+                sucesso = 0;
+                break;
+            }
+            grupo->pontos = novos;
+            grupo->capacidade = novoTotal;
+        }
+    }
+
+    if (sucesso) {
+        // Soma acumulada das linhas (primeira linha de cada bloco) e dos totais por frequência (posição de cada bloco)
+        int linhas = 0;
+        for (int i = 0; i < total; i++) {
+            blocos[i].linhaInicial = linhas + 1;
+            linhas += blocos[i].linhas;
+            if (blocos[i].local.nColunas > mapa->nColunas) mapa->nColunas = blocos[i].local.nColunas;
+            mapa->totalAntenas += blocos[i].local.totalAntenas;
+        }
+        for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+            for (int i = 0; i < total; i++) {
+                blocos[i].destino[f] = mapa->grupos[f].total;
+                mapa->grupos[f].total += blocos[i].local.grupos[f].total;
+            }
+        }
+        mapa->nLinhas = linhas;
+
+        executarBlocos(blocos, total, juntarBloco);
+    }
+
+    for (int i = 0; i < total; i++) {
+        libertarMapaFrequencias(&blocos[i].local);
+    }
+    free(blocos);
+    free(dados);
+    return sucesso;
+}
@@ -0,0 +1,18 @@
+/*
+ *  @file funcoes_leitura.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-08-04
+ *  @project EDA
+ *
+ *  Declarao da leitura de ficheiros de mapa em paralelo: o ficheiro  dividido em blocos
+ *  de linhas completas, lidos por vrias threads.
+ */
+
+#ifndef FUNCOES_LEITURA_H
+#define FUNCOES_LEITURA_H
+
+#include "dados.h"
+
+int carregarMapaFrequenciasParalelo(const char* filename, MapaFrequencias* mapa, int numThreads);
+
+#endif // FUNCOES_LEITURA_H
@@ -0,0 +1,227 @@
+﻿/*
+ *  @file funcoes_lote.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-09
+ *  @project EDA
+ *
+ *  Implementação do processamento em lote de ficheiros de mapa. Cada ficheiro é carregado,
+ *  analisado (nefastos e grafo) e resumido num ResultadoMapa próprio, por um conjunto fixo de threads.
+ *  As tarefas não escrevem no ecrã: os resultados são apresentados no fim, pela ordem dos ficheiros.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <threads.h>
+#include "funcoes.h"
+#include "funcoes_grafos.h"
+#include "funcoes_raster.h"
+#include "funcoes_lote.h"
+
+/// <summary>
+/// Estado partilhado pelas threads de um lote: a lista de ficheiros, os resultados
+/// e o índice do próximo ficheiro por processar (protegido pelo mutex).
+/// </summary>
+typedef struct {
+    const char** ficheiros;
+    ResultadoMapa* resultados;
+    int total;
+    int proximo;
+    mtx_t mutex;
+} Lote;
+
+/// <summary>
+/// Constrói o grafo de um mapa de frequências e preenche as arestas e componentes do resultado.
+/// O grafo é alocado pela própria tarefa, para que cada mapa tenha o seu estado isolado.
+/// Se o mapa exceder MAX_VERTICES, as arestas e componentes ficam a -1.
+/// </summary>
+/// <returns>1 em caso de sucesso, 0 se não foi possível alocar o grafo.</returns>
+static int analisarGrafo(const MapaFrequencias* mapa, ResultadoMapa* resultado) {
+    resultado->totalArestas = -1;
+    resultado->totalComponentes = -1;
+    if (mapa->totalAntenas > MAX_VERTICES) return 1;
+
+    Grafo* g = malloc(sizeof(Grafo));
+    if (!g) return 0;
+    inicializarGrafo(g);
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            inserirVertice(g, (char)f, grupo->pontos[i].x, grupo->pontos[i].y);
+        }
+    }
+    criarArestasPorFrequencia(g);
+
+    resultado->totalArestas = contarArestasGrafo(g);
+    resultado->totalComponentes = contarComponentesGrafo(g, NULL);
+
+    libertarGrafo(g);
+    free(g);
+    return 1;
+}
+
+/// <summary>
+/// Processa um ficheiro de mapa: carrega as antenas, calcula os nefastos no raster compacto
+/// e analisa o grafo. Não usa variáveis globais nem escreve no ecrã; os erros ficam no resultado.
+/// </summary>
+/// <param name="ficheiro">Nome do ficheiro de mapa.</param>
+/// <param name="resultado">Resultado a preencher.</param>
+void processarMapa(const char* ficheiro, ResultadoMapa* resultado) {
+    memset(resultado, 0, sizeof(ResultadoMapa));
+    resultado->ficheiro = ficheiro;
+    resultado->totalArestas = -1;
+    resultado->totalComponentes = -1;
+
+    FILE* fp = fopen(ficheiro, "r");
+    if (!fp) {
+        snprintf(resultado->erro, sizeof(resultado->erro), "Erro ao abrir ficheiro (errno %d)", errno);
+        return;
+    }
+
+    MapaFrequencias* mapa = malloc(sizeof(MapaFrequencias));
+    if (!mapa) {
+        fclose(fp);
+        snprintf(resultado->erro, sizeof(resultado->erro), "Erro de alocacao");
+        return;
+    }
+    inicializarMapaFrequencias(mapa);
+    int lido = lerMapaFrequencias(fp, mapa);
+    fclose(fp);
+    if (!lido) {
+        snprintf(resultado->erro, sizeof(resultado->erro), "Erro de alocacao ao ler o mapa");
+        libertarMapaFrequencias(mapa);
+        free(mapa);
+        return;
+    }
+
+    resultado->nLinhas = mapa->nLinhas;
+    resultado->nColunas = mapa->nColunas;
+    resultado->totalAntenas = mapa->totalAntenas;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (mapa->grupos[f].total > 0) resultado->totalFrequencias++;
+    }
+
+    if (mapa->totalAntenas > 0) {
+        RasterCompacto raster;
+        if (construirRasterCompacto(mapa, &raster) != 1) {
+            snprintf(resultado->erro, sizeof(resultado->erro), "Erro de alocacao ao criar o raster");
+            libertarMapaFrequencias(mapa);
+            free(mapa);
+            return;
+        }
+        resultado->rasterRows = raster.nRows;
+        resultado->rasterCols = raster.nCols;
+        resultado->totalNefastos = contarNefastosRaster(&raster);
+        libertarRasterCompacto(&raster);
+    }
+
+    if (analisarGrafo(mapa, resultado))
+        resultado->sucesso = 1;
+    else
+        snprintf(resultado->erro, sizeof(resultado->erro), "Erro de alocacao ao criar o grafo");
+
+    libertarMapaFrequencias(mapa);
+    free(mapa);
+}
+
+/// <summary>
+/// Função executada por cada thread do lote: retira ficheiros da lista até não haver mais.
+/// </summary>
+static int trabalhadorLote(void* arg) {
+    Lote* lote = (Lote*)arg;
+    for (;;) {
+        mtx_lock(&lote->mutex);
+        int indice = lote->proximo++;
+        mtx_unlock(&lote->mutex);
+
+        if (indice >= lote->total) break;
+        processarMapa(lote->ficheiros[indice], &lote->resultados[indice]);
+    }
+    return 0;
+}
+
+/// <summary>
+/// Processa uma lista de ficheiros de mapa com um conjunto fixo de threads.
+/// Cada ficheiro é atribuído à próxima thread livre e o seu resultado fica na mesma posição
+/// do vetor de resultados, pelo que a ordem final não depende do escalonamento.
+/// </summary>
+/// <param name="ficheiros">Nomes dos ficheiros de mapa.</param>
+/// <param name="total">Número de ficheiros.</param>
+/// <param name="numThreads">Número de threads a usar (pelo menos 1).</param>
+/// <param name="resultados">Vetor com 'total' posições onde são guardados os resultados.</param>
+/// <returns>Número de ficheiros processados com sucesso.</returns>
+int processarLoteMapas(const char** ficheiros, int total, int numThreads, ResultadoMapa* resultados) {
+    // Os resultados ficam sempre definidos, mesmo que o lote não chegue a ser processado
+    for (int i = 0; i < total; i++) {
+        memset(&resultados[i], 0, sizeof(ResultadoMapa));
+        resultados[i].ficheiro = ficheiros[i];
+        resultados[i].totalArestas = -1;
+        resultados[i].totalComponentes = -1;
+        snprintf(resultados[i].erro, sizeof(resultados[i].erro), "Ficheiro nao processado");
+    }
+    if (total <= 0) return 0;
+
+    Lote lote;
+    lote.ficheiros = ficheiros;
+    lote.resultados = resultados;
+    lote.total = total;
+    lote.proximo = 0;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > total) numThreads = total;
+
+    thrd_t* threads = malloc(numThreads * sizeof(thrd_t));
+    if (!threads || mtx_init(&lote.mutex, mtx_plain) != thrd_success) {
+        printf("Erro ao preparar as threads do lote.\n");
+        free(threads);
+        return 0;
+    }
+
+    // Se não for possível criar uma thread, o trabalho fica para as restantes (ou para esta)
+    int criadas = 0;
+    for (int i = 0; i < numThreads; i++) {
+        if (thrd_create(&threads[criadas], trabalhadorLote, &lote) == thrd_success)
+            criadas++;
+    }
+    if (criadas == 0)
+        trabalhadorLote(&lote);
+    for (int i = 0; i < criadas; i++) {
+        thrd_join(threads[i], NULL);
+    }
+
+    mtx_destroy(&lote.mutex);
+    free(threads);
+
+    int sucessos = 0;
+    for (int i = 0; i < total; i++) {
+        if (resultados[i].sucesso) sucessos++;
+    }
+    return sucessos;
+}
+
+/// <summary>
+/// Apresenta os resultados de um lote em forma de tabela, pela ordem dos ficheiros.
+/// </summary>
+/// <param name="resultados">Vetor de resultados.</param>
+/// <param name="total">Número de resultados.</param>
+/// <param name="saida">Ficheiro onde é escrita a tabela (por exemplo, stdout).</param>
+void imprimirResultadosLote(const ResultadoMapa* resultados, int total, FILE* saida) {
+    fprintf(saida, "\nResultados do lote\n");
+    fprintf(saida, "Ficheiro | Mapa | Antenas | Freqs | Matriz | Nefastos | Arestas | Componentes\n");
+    fprintf(saida, "--------------------------------------------------------------------------\n");
+    for (int i = 0; i < total; i++) {
+        const ResultadoMapa* r = &resultados[i];
+        if (!r->sucesso) {
+            fprintf(saida, "%s | %s\n", r->ficheiro, r->erro);
+            continue;
+        }
+        fprintf(saida, "%s | %dx%d | %d | %d | %dx%d | %lld | ",
+            r->ficheiro, r->nLinhas, r->nColunas, r->totalAntenas, r->totalFrequencias,
+            r->rasterRows, r->rasterCols, r->totalNefastos);
+        if (r->totalComponentes >= 0)
+            fprintf(saida, "%d | %d\n", r->totalArestas, r->totalComponentes);
+        else
+            fprintf(saida, "- | - (mais de %d antenas)\n", MAX_VERTICES);
+    }
+}
@@ -0,0 +1,24 @@
+/*
+ *  @file funcoes_lote.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-09
+ *  @project EDA
+ *
+ *  Declarao das funes de processamento em lote de vrios ficheiros de mapa
+ *  com um conjunto fixo de threads.
+ */
+
+#ifndef FUNCOES_LOTE_H
+#define FUNCOES_LOTE_H
+
+#include <stdio.h>
+#include "dados.h"
+
+// Processamento de um mapa (sem estado partilhado)
+void processarMapa(const char* ficheiro, ResultadoMapa* resultado);
+
+// Processamento em lote
+int processarLoteMapas(const char** ficheiros, int total, int numThreads, ResultadoMapa* resultados);
+void imprimirResultadosLote(const ResultadoMapa* resultados, int total, FILE* saida);
+
+#endif // FUNCOES_LOTE_H
@@ -0,0 +1,431 @@
+﻿/*
+ *  @file funcoes_pipeline.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-21
+ *  @project EDA
+ *
+ *  Implementação da escrita da matriz com nefastos em pipeline:
+ *   - uma thread de leitura lê o ficheiro por bandas de linhas e envia as antenas de cada banda
+ *     ao trabalhador responsável pela sua frequência;
+ *   - cada trabalhador junta as antenas aos grupos das suas frequências e gera logo os nefastos
+ *     dos pares que cada nova antena forma com as anteriores, enquanto a leitura continua;
+ *   - depois da última antena (qualquer antena pode criar nefastos em linhas já lidas), os
+ *     trabalhadores desenham bandas alternadas e a thread que chamou a função escreve-as por ordem.
+ *  As etapas estão ligadas por filas circulares de capacidade fixa, com um produtor e um consumidor
+ *  cada, sem trincos. O resultado é igual ao de imprimirFicheiroEmBandas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <threads.h>
+#include "funcoes.h"
+#include "funcoes_raster.h"
+#include "funcoes_pipeline.h"
+
+#define CAPACIDADE_FILA 8
+#define MAX_TRABALHADORES 16
+
+// Valores de erro do pipeline (0 quando não houve erro)
+#define ERRO_ALOCACAO 2
+#define ERRO_DEMASIADOS_NEFASTOS 3
+
+/// <summary>
+/// Fila circular de capacidade fixa com um único produtor e um único consumidor.
+/// O início e o fim ficam em linhas de cache diferentes, para que as duas threads não disputem a mesma linha.
+/// </summary>
+typedef struct {
+    _Atomic size_t inicio;             // Alterado apenas pelo consumidor
+    char preenchimentoInicio[64 - sizeof(size_t)];
+    _Atomic size_t fim;                // Alterado apenas pelo produtor
+    char preenchimentoFim[64 - sizeof(size_t)];
+    void* itens[CAPACIDADE_FILA];
+} FilaCircular;
+
+/// <summary>
+/// Antenas de uma banda destinadas a um trabalhador (NULL assinala o fim do ficheiro).
+/// </summary>
+typedef struct {
+    int total, capacidade;
+    char* freqs;
+    Coordenada* pontos;
+} PacoteAntenas;
+
+/// <summary>
+/// Texto de uma banda já desenhada (NULL em texto assinala um erro ao desenhá-la).
+/// </summary>
+typedef struct {
+    char* texto;
+    size_t tamanho;
+} BandaDesenhada;
+
+/// <summary>
+/// Estado partilhado pelas etapas do pipeline.
+/// Cada grupo de frequência do mapa é alterado apenas pelo trabalhador dessa frequência.
+/// </summary>
+typedef struct {
+    FILE* fp;
+    int alturaBanda;
+    int numTrabalhadores;
+    MapaFrequencias* mapa;
+    FilaCircular entrada[MAX_TRABALHADORES];  // Leitura -> trabalhador
+    FilaCircular saida[MAX_TRABALHADORES];    // Trabalhador -> escrita
+    IndiceEspacial nefastos[MAX_TRABALHADORES];
+    atomic_int calculosTerminados;
+    atomic_int erro;
+} Pipeline;
+
+typedef struct {
+    Pipeline* pipeline;
+    int indice;
+} Trabalhador;
+
+#pragma region Filas Circulares
+
+/// <summary>
+/// Coloca um item na fila, esperando (sem trincos) enquanto esta estiver cheia.
+/// </summary>
+static void colocarFila(FilaCircular* fila, void* item) {
+    size_t fim = atomic_load_explicit(&fila->fim, memory_order_relaxed);
+    while (fim - atomic_load_explicit(&fila->inicio, memory_order_acquire) == CAPACIDADE_FILA) thrd_yield();
+    fila->itens[fim % CAPACIDADE_FILA] = item;
+    atomic_store_explicit(&fila->fim, fim + 1, memory_order_release);
+}
+
+/// <summary>
+/// Retira um item da fila, esperando (sem trincos) enquanto esta estiver vazia.
+/// </summary>
+static void* retirarFila(FilaCircular* fila) {
+    size_t inicio = atomic_load_explicit(&fila->inicio, memory_order_relaxed);
+    while (atomic_load_explicit(&fila->fim, memory_order_acquire) == inicio) thrd_yield();
+    void* item = fila->itens[inicio % CAPACIDADE_FILA];
+    atomic_store_explicit(&fila->inicio, inicio + 1, memory_order_release);
+    return item;
+}
+
+#pragma endregion
+
+#pragma region Leitura
+
+/// <summary>
+/// Acrescenta uma antena a um pacote, aumentando-o se necessário.
+/// </summary>
+static int acrescentarPacote(PacoteAntenas* pacote, char freq, int x, int y) {
+    if (pacote->total == pacote->capacidade) {
+        int capacidade = pacote->capacidade ? pacote->capacidade * 2 : 16;
+        char* freqs = realloc(pacote->freqs, capacidade * sizeof(char));
+        if (freqs == NULL) return 0;
+        pacote->freqs = freqs;
+        Coordenada* pontos = realloc(pacote->pontos, capacidade * sizeof(Coordenada));
+        if (pontos == NULL) return 0;
+        pacote->pontos = pontos;
+        pacote->capacidade = capacidade;
+    }
+    pacote->freqs[pacote->total] = freq;
+    pacote->pontos[pacote->total].x = x;
+    pacote->pontos[pacote->total].y = y;
+    pacote->total++;
+    return 1;
+}
+
+/// <summary>
+/// Liberta um pacote de antenas.
+/// </summary>
+static void libertarPacote(PacoteAntenas* pacote) {
+    free(pacote->freqs);
+    free(pacote->pontos);
+    free(pacote);
+}
+
+/// <summary>
+/// Envia a cada trabalhador o pacote da banda atual (mesmo vazio não é enviado) e prepara pacotes novos.
+/// </summary>
+static int enviarPacotes(Pipeline* p, PacoteAntenas** pacotes) {
+    for (int w = 0; w < p->numTrabalhadores; w++) {
+        if (pacotes[w] != NULL && pacotes[w]->total > 0) {
+            colocarFila(&p->entrada[w], pacotes[w]);
+            pacotes[w] = NULL;
+        }
+        if (pacotes[w] == NULL) {
+            pacotes[w] = calloc(1, sizeof(PacoteAntenas));
+            if (pacotes[w] == NULL) return 0;
+        }
+    }
+    return 1;
+}
+
+/// <summary>
+/// Thread de leitura: lê o ficheiro como lerMapaFrequencias e, no fim de cada banda de linhas,
+/// envia as antenas lidas aos trabalhadores (a frequência f pertence ao trabalhador f % numTrabalhadores).
+/// </summary>
+static int lerEmBandas(void* arg) {
+    Pipeline* p = (Pipeline*)arg;
+    PacoteAntenas* pacotes[MAX_TRABALHADORES] = { NULL };
+    int x = 1, y = 1;
+    int c;
+
+    int sucesso = enviarPacotes(p, pacotes);
+    while (sucesso && (c = getc(p->fp)) != EOF) {
+        if (c == '\n') {
+            if (x % p->alturaBanda == 0) sucesso = enviarPacotes(p, pacotes);
+            x++;
+            y = 1;
+            continue;
+        }
+        if (c == '\r') continue;
+
+        if (c != '.' && c != ' ') {
+            sucesso = acrescentarPacote(pacotes[(unsigned char)c % p->numTrabalhadores], (char)c, x, y);
+        }
+        y++;
+    }
+    if (sucesso) sucesso = enviarPacotes(p, pacotes);
+    if (!sucesso) atomic_store(&p->erro, ERRO_ALOCACAO);
+
+    for (int w = 0; w < p->numTrabalhadores; w++) {
+        if (pacotes[w] != NULL) libertarPacote(pacotes[w]);
+        colocarFila(&p->entrada[w], NULL);
+    }
+    return 0;
+}
+
+#pragma endregion
+
+#pragma region Cálculo e Desenho
+
+/// <summary>
+/// Acrescenta um nefasto à lista do trabalhador. Quando a lista fica cheia, é ordenada e limpa de
+/// repetidos, e só cresce se mais de metade das posições tiverem nefastos distintos; assim, a memória
+/// é proporcional ao número de nefastos distintos e não ao número de pares de antenas.
+/// </summary>
+/// <returns>1 em caso de sucesso, ERRO_ALOCACAO ou ERRO_DEMASIADOS_NEFASTOS em caso de erro.</returns>
+static int acrescentarNefasto(IndiceEspacial* nefastos, int* capacidade, int x, int y) {
+    if (nefastos->total == *capacidade) {
+        nefastos->total = (int)ordenarCoordenadasSemRepetidos(nefastos->pontos, nefastos->total);
+        if (*capacidade == 0 || nefastos->total > *capacidade / 2) {
+            if (*capacidade > INT_MAX / 2) return ERRO_DEMASIADOS_NEFASTOS;
+            int nova = *capacidade ? *capacidade * 2 : 64;
+            Coordenada* pontos = realloc(nefastos->pontos, nova * sizeof(Coordenada));
+            if (pontos == NULL) return ERRO_ALOCACAO;
+            nefastos->pontos = pontos;
+            *capacidade = nova;
+        }
+    }
+    nefastos->pontos[nefastos->total].x = x;
+    nefastos->pontos[nefastos->total].y = y;
+    nefastos->total++;
+    return 1;
+}
+
+/// <summary>
+/// Recebe as antenas enviadas pela leitura e, para cada nova antena, gera os dois simétricos
+/// de cada par que forma com as antenas anteriores da mesma frequência.
+/// No fim ordena os nefastos e elimina os repetidos que ainda restem.
+/// </summary>
+static void calcularNefastosTrabalhador(Pipeline* p, int w) {
+    IndiceEspacial* nefastos = &p->nefastos[w];
+    int capacidade = 0;
+    PacoteAntenas* pacote;
+
+    while ((pacote = retirarFila(&p->entrada[w])) != NULL) {
+        for (int i = 0; i < pacote->total && !atomic_load_explicit(&p->erro, memory_order_relaxed); i++) {
+            GrupoFrequencia* grupo = &p->mapa->grupos[(unsigned char)pacote->freqs[i]];
+            const Coordenada* q = &pacote->pontos[i];
+            for (int j = 0; j < grupo->total; j++) {
+                const Coordenada* a = &grupo->pontos[j];
+                int resultado = acrescentarNefasto(nefastos, &capacidade, 2 * q->x - a->x, 2 * q->y - a->y);
+                if (resultado == 1) resultado = acrescentarNefasto(nefastos, &capacidade, 2 * a->x - q->x, 2 * a->y - q->y);
+                if (resultado != 1) {
+                    atomic_store(&p->erro, resultado);
+                    break;
+                }
+            }
+            if (!adicionarCoordenadaGrupo(grupo, q->x, q->y)) atomic_store(&p->erro, ERRO_ALOCACAO);
+        }
+        libertarPacote(pacote);
+    }
+
+    nefastos->total = (int)ordenarCoordenadasSemRepetidos(nefastos->pontos, nefastos->total);
+}
+
+/// <summary>
+/// Espera que todos os trabalhadores terminem o cálculo (todas as antenas lidas e todos os nefastos gerados).
+/// </summary>
+static void esperarCalculos(Pipeline* p) {
+    while (atomic_load(&p->calculosTerminados) < p->numTrabalhadores) thrd_yield();
+}
+
+/// <summary>
+/// Indica se foi lida alguma antena (só pode ser chamada depois de todos os cálculos terminarem).
+/// </summary>
+static int temAntenas(const Pipeline* p) {
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (p->mapa->grupos[f].total > 0) return 1;
+    }
+    return 0;
+}
+
+/// <summary>
+/// Desenha as linhas [linhaInicio, linhaFim] como texto, cada uma terminada por '\n': antenas (de todos
+/// os grupos) e nefastos (das listas de todos os trabalhadores) que não se sobreponham a antenas.
+/// </summary>
+static BandaDesenhada* desenharBanda(Pipeline* p, int linhaInicio, int linhaFim, int minY, int nCols) {
+    int linhas = linhaFim - linhaInicio + 1;
+    BandaDesenhada* banda = malloc(sizeof(BandaDesenhada));
+    if (banda == NULL) return NULL;
+    banda->tamanho = (size_t)linhas * (nCols + 1);
+    banda->texto = malloc(banda->tamanho);
+    if (banda->texto == NULL) return banda;
+
+    for (int l = 0; l < linhas; l++) {
+        memset(banda->texto + (size_t)l * (nCols + 1), '.', nCols);
+        banda->texto[(size_t)l * (nCols + 1) + nCols] = '\n';
+    }
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &p->mapa->grupos[f];
+        for (int i = primeiroPontoComLinha(grupo, linhaInicio); i < grupo->total && grupo->pontos[i].x <= linhaFim; i++) {
+            banda->texto[(size_t)(grupo->pontos[i].x - linhaInicio) * (nCols + 1) + grupo->pontos[i].y - minY] = (char)f;
+        }
+    }
+
+    for (int w = 0; w < p->numTrabalhadores; w++) {
+        const IndiceEspacial* nefastos = &p->nefastos[w];
+        for (int i = procurarPontoIndice(nefastos, linhaInicio, INT_MIN); i < nefastos->total && nefastos->pontos[i].x <= linhaFim; i++) {
+            char* celula = &banda->texto[(size_t)(nefastos->pontos[i].x - linhaInicio) * (nCols + 1) + nefastos->pontos[i].y - minY];
+            if (*celula == '.') *celula = '#';
+        }
+    }
+    return banda;
+}
+
+/// <summary>
+/// Thread de cálculo: gera os nefastos das suas frequências enquanto a leitura decorre e,
+/// depois de todos terminarem, desenha as bandas w, w + numTrabalhadores, ... e envia-as à escrita.
+/// </summary>
+static int executarTrabalhador(void* arg) {
+    Trabalhador* t = (Trabalhador*)arg;
+    Pipeline* p = t->pipeline;
+    int w = t->indice;
+
+    calcularNefastosTrabalhador(p, w);
+    atomic_fetch_add(&p->calculosTerminados, 1);
+    esperarCalculos(p);
+    if (atomic_load(&p->erro) || !temAntenas(p)) return 0;
+
+    int minX, maxX, minY, maxY;
+    calcularLimitesMapa(p->mapa, &minX, &maxX, &minY, &maxY);
+    int nCols = maxY - minY + 1;
+    for (int linhaInicio = minX + w * p->alturaBanda; linhaInicio <= maxX; linhaInicio += p->numTrabalhadores * p->alturaBanda) {
+        int linhaFim = linhaInicio + p->alturaBanda - 1;
+        if (linhaFim > maxX) linhaFim = maxX;
+        colocarFila(&p->saida[w], desenharBanda(p, linhaInicio, linhaFim, minY, nCols));
+    }
+    return 0;
+}
+
+#pragma endregion
+
+/// <summary>
+/// Lê um ficheiro de mapa e escreve a matriz com nefastos em pipeline: leitura, cálculo dos nefastos
+/// e escrita decorrem em simultâneo em threads diferentes. O resultado é igual ao de imprimirFicheiroEmBandas.
+/// </summary>
+/// <param name="filename">Nome do ficheiro a processar.</param>
+/// <param name="alturaBanda">Número de linhas de cada banda.</param>
+/// <param name="numTrabalhadores">Número de threads de cálculo (entre 1 e MAX_TRABALHADORES).</param>
+/// <param name="saida">Ficheiro onde é escrita a matriz (por exemplo, stdout).</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int imprimirFicheiroEmPipeline(const char* filename, int alturaBanda, int numTrabalhadores, FILE* saida) {
+    if (alturaBanda <= 0) {
+        fprintf(stderr, "Altura de banda inválida: %d\n", alturaBanda);
+        return 0;
+    }
+    if (numTrabalhadores < 1) numTrabalhadores = 1;
+    if (numTrabalhadores > MAX_TRABALHADORES) numTrabalhadores = MAX_TRABALHADORES;
+
+    Pipeline* p = calloc(1, sizeof(Pipeline));
+    if (p == NULL || (p->mapa = malloc(sizeof(MapaFrequencias))) == NULL) {
+        perror("Erro na alocação do pipeline");
+        free(p);
+        return 0;
+    }
+    p->fp = fopen(filename, "r");
+    if (p->fp == NULL) {
+        perror("Erro ao abrir ficheiro");
+        free(p->mapa);
+        free(p);
+        return 0;
+    }
+    inicializarMapaFrequencias(p->mapa);
+    p->alturaBanda = alturaBanda;
+    p->numTrabalhadores = numTrabalhadores;
+    atomic_init(&p->calculosTerminados, 0);
+    atomic_init(&p->erro, 0);
+    for (int w = 0; w < numTrabalhadores; w++) {
+        atomic_init(&p->entrada[w].inicio, 0);
+        atomic_init(&p->entrada[w].fim, 0);
+        atomic_init(&p->saida[w].inicio, 0);
+        atomic_init(&p->saida[w].fim, 0);
+    }
+
+    // Cria os trabalhadores e só depois a leitura; a escrita é feita por esta thread
+    Trabalhador trabalhadores[MAX_TRABALHADORES];
+    thrd_t threads[MAX_TRABALHADORES + 1];
+    int criadas = 0;
+    int sucesso = 1;
+    for (int w = 0; sucesso && w < numTrabalhadores; w++) {
+        trabalhadores[w].pipeline = p;
+        trabalhadores[w].indice = w;
+        sucesso = thrd_create(&threads[criadas], executarTrabalhador, &trabalhadores[w]) == thrd_success;
+        if (sucesso) criadas++;
+    }
+    if (sucesso) {
+        sucesso = thrd_create(&threads[criadas], lerEmBandas, p) == thrd_success;
+        if (sucesso) criadas++;
+    }
+
+    if (!sucesso) {
+        // Sem leitura, os trabalhadores criados recebem já o fim e terminam sem desenhar
+        fprintf(stderr, "Erro ao criar as threads do pipeline.\n");
+        atomic_store(&p->erro, ERRO_ALOCACAO);
+        for (int w = 0; w < criadas; w++) colocarFila(&p->entrada[w], NULL);
+        atomic_fetch_add(&p->calculosTerminados, numTrabalhadores - criadas);
+    }
+    else {
+        esperarCalculos(p);
+        if (!temAntenas(p)) {
+            fprintf(stderr, "Lista de antenas vazia. Sem dados para criar a matriz.\n");
+            sucesso = 0;
+        }
+        else if (atomic_load(&p->erro) == ERRO_DEMASIADOS_NEFASTOS) {
+            fprintf(stderr, "Demasiados nefastos distintos para um trabalhador do pipeline.\n");
+            sucesso = 0;
+        }
+        else if (atomic_load(&p->erro)) {
+            fprintf(stderr, "Erro de alocação no pipeline.\n");
+            sucesso = 0;
+        }
+        else {
+            int minX, maxX, minY, maxY;
+            calcularLimitesMapa(p->mapa, &minX, &maxX, &minY, &maxY);
+            int nBandas = (maxX - minX + alturaBanda) / alturaBanda;
+            for (int b = 0; b < nBandas; b++) {
+                BandaDesenhada* banda = retirarFila(&p->saida[b % numTrabalhadores]);
+                if (banda == NULL || banda->texto == NULL) sucesso = 0;
+                else if (sucesso) fwrite(banda->texto, 1, banda->tamanho, saida);
+                if (banda != NULL) free(banda->texto);
+                free(banda);
+            }
+            if (!sucesso) fprintf(stderr, "Erro de alocação ao desenhar uma banda.\n");
+        }
+    }
+
+    for (int i = 0; i < criadas; i++) thrd_join(threads[i], NULL);
+    fclose(p->fp);
+    for (int w = 0; w < numTrabalhadores; w++) libertarIndiceEspacial(&p->nefastos[w]);
+    libertarMapaFrequencias(p->mapa);
+    free(p->mapa);
+    free(p);
+    return sucesso;
+}
@@ -0,0 +1,19 @@
+/*
+ *  @file funcoes_pipeline.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-21
+ *  @project EDA
+ *
+ *  Declarao da escrita da matriz com nefastos em pipeline: leitura, clculo e escrita
+ *  em threads diferentes, ligadas por filas circulares sem trincos.
+ */
+
+#ifndef FUNCOES_PIPELINE_H
+#define FUNCOES_PIPELINE_H
+
+#include <stdio.h>
+#include "dados.h"
+
+int imprimirFicheiroEmPipeline(const char* filename, int alturaBanda, int numTrabalhadores, FILE* saida);
+
+#endif // FUNCOES_PIPELINE_H
@@ -0,0 +1,471 @@
+﻿/*
+ *  @file funcoes_publicacao.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-30
+ *  @project EDA
+ *
+ *  Implementação da publicação do grafo para leitura concorrente. O escritor aplica as alterações
+ *  à sua cópia de trabalho (Grafo), cria uma cópia imutável com as adjacências em vetores contínuos
+ *  e troca-a atomicamente pela versão publicada. Os leitores anunciam a época em que entram e nunca
+ *  usam trincos; uma versão retirada só é libertada quando todos os leitores ativos tiverem entrado
+ *  numa época posterior.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "funcoes_grafos.h"
+#include "funcoes_publicacao.h"
+
+#pragma region Cópias Imutáveis
+
+/// <summary>
+/// Calcula a posição inicial de uma coordenada numa tabela com capacidade potência de 2.
+/// </summary>
+static int posicaoImutavel(int x, int y, int capacidade) {
+    unsigned int h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u;
+    h ^= h >> 15;
+    return (int)(h & (unsigned int)(capacidade - 1));
+}
+
+/// <summary>
+/// Liberta uma cópia imutável do grafo.
+/// </summary>
+static void libertarGrafoImutavel(GrafoImutavel* s) {
+    if (s == NULL) return;
+    free(s->freqs);
+    free(s->posicoes);
+    free(s->inicioAdjacentes);
+    free(s->adjacentes);
+    free(s->porFrequencia);
+    free(s->tabelaCoord);
+    free(s->componente);
+    free(s);
+}
+
+/// <summary>
+/// Cria uma cópia imutável do grafo de trabalho. As adjacências de cada vértice mantêm a ordem
+/// das listas do grafo, pelo que as travessias visitam os vértices pela mesma ordem.
+/// </summary>
+static GrafoImutavel* criarGrafoImutavel(const Grafo* g) {
+    int n = g->tamanho;
+    int arestas = 0;
+    for (int v = 0; v < n; v++) {
+        for (const Adjacente* adj = g->vertices[v].adjacentes; adj != NULL; adj = adj->seguinte) arestas++;
+    }
+    int capacidade = 16;
+    while (capacidade < 2 * n) capacidade *= 2;
+
+    GrafoImutavel* s = calloc(1, sizeof(GrafoImutavel));
+    if (s == NULL) return NULL;
+    s->tamanho = n;
+    s->capacidadeTabela = capacidade;
+    s->freqs = malloc((n + 1) * sizeof(char));
+    s->posicoes = malloc((n + 1) * sizeof(Coordenada));
+    s->inicioAdjacentes = malloc((n + 1) * sizeof(int));
+    s->adjacentes = malloc((arestas + 1) * sizeof(int));
+    s->porFrequencia = malloc((n + 1) * sizeof(int));
+    s->tabelaCoord = malloc(capacidade * sizeof(int));
+    s->componente = malloc((n + 1) * sizeof(int));
+    if (!s->freqs || !s->posicoes || !s->inicioAdjacentes || !s->adjacentes || !s->porFrequencia
+        || !s->tabelaCoord || !s->componente) {
+        libertarGrafoImutavel(s);
+        return NULL;
+    }
+
+    int k = 0;
+    memset(s->tabelaCoord, -1, capacidade * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        const Vertice* vert = &g->vertices[v];
+        s->freqs[v] = vert->freq;
+        s->posicoes[v].x = vert->x;
+        s->posicoes[v].y = vert->y;
+        s->inicioAdjacentes[v] = k;
+        for (const Adjacente* adj = vert->adjacentes; adj != NULL; adj = adj->seguinte) {
+            s->adjacentes[k++] = adj->destino;
+        }
+
+        int pos = posicaoImutavel(vert->x, vert->y, capacidade);
+        while (s->tabelaCoord[pos] != -1) pos = (pos + 1) & (capacidade - 1);
+        s->tabelaCoord[pos] = v;
+    }
+    s->inicioAdjacentes[n] = k;
+
+    // Agrupa os vértices por frequência (contagem e soma de prefixos), mantendo a ordem dos índices
+    for (int v = 0; v < n; v++) s->inicioFrequencia[(unsigned char)s->freqs[v] + 1]++;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) s->inicioFrequencia[f + 1] += s->inicioFrequencia[f];
+    int proximo[NUM_FREQUENCIAS];
+    memcpy(proximo, s->inicioFrequencia, sizeof(proximo));
+    for (int v = 0; v < n; v++) s->porFrequencia[proximo[(unsigned char)s->freqs[v]]++] = v;
+
+    // Componentes ligadas, para responder a pedidos de alcance sem percorrer o grafo
+    int fila[MAX_VERTICES];
+    for (int v = 0; v < n; v++) s->componente[v] = -1;
+    for (int v = 0; v < n; v++) {
+        if (s->componente[v] != -1) continue;
+        int inicio = 0, fim = 0;
+        fila[fim++] = v;
+        s->componente[v] = s->totalComponentes;
+        while (inicio < fim) {
+            int atual = fila[inicio++];
+            for (int a = s->inicioAdjacentes[atual]; a < s->inicioAdjacentes[atual + 1]; a++) {
+                if (s->componente[s->adjacentes[a]] == -1) {
+                    s->componente[s->adjacentes[a]] = s->totalComponentes;
+                    fila[fim++] = s->adjacentes[a];
+                }
+            }
+        }
+        s->totalComponentes++;
+    }
+
+    return s;
+}
+
+#pragma endregion
+
+#pragma region Publicação e Reclamação
+
+/// <summary>
+/// Liberta as versões retiradas que já não podem estar a ser lidas: as retiradas numa época
+/// anterior à menor época anunciada pelos leitores ativos.
+/// </summary>
+static void recolherRetirados(GrafoPublicado* pub) {
+    uint64_t minima = UINT64_MAX;
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        uint64_t e = atomic_load(&pub->leitores[i].epoca);
+        if (e != 0 && e < minima) minima = e;
+    }
+
+    GrafoImutavel** anterior = &pub->retirados;
+    while (*anterior != NULL) {
+        GrafoImutavel* s = *anterior;
+        if (s->epocaRetirado < minima) {
+            *anterior = s->seguinteRetirado;
+            libertarGrafoImutavel(s);
+        }
+        else {
+            anterior = &s->seguinteRetirado;
+        }
+    }
+}
+
+/// <summary>
+/// Publica uma nova cópia imutável do grafo de trabalho. A versão anterior fica marcada com a época
+/// atual e a época avança: um leitor que anuncie a nova época já só pode obter a nova versão.
+/// </summary>
+static int publicarGrafo(GrafoPublicado* pub) {
+    GrafoImutavel* novo = criarGrafoImutavel(pub->grafo);
+    if (novo == NULL) {
+        printf("Erro ao publicar o grafo.\n");
+        return 0;
+    }
+
+    GrafoImutavel* antigo = atomic_exchange(&pub->atual, novo);
+    if (antigo != NULL) {
+        antigo->epocaRetirado = atomic_fetch_add(&pub->epocaGlobal, 1);
+        antigo->seguinteRetirado = pub->retirados;
+        pub->retirados = antigo;
+    }
+    recolherRetirados(pub);
+    return 1;
+}
+
+/// <summary>
+/// Inicializa as épocas e os leitores e reserva a cópia de trabalho (vazia) do grafo.
+/// </summary>
+static int prepararGrafoPublicado(GrafoPublicado* pub) {
+    atomic_init(&pub->atual, NULL);
+    atomic_init(&pub->epocaGlobal, 1);
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        atomic_init(&pub->leitores[i].epoca, 0);
+        atomic_init(&pub->leitores[i].ocupado, 0);
+    }
+    pub->retirados = NULL;
+
+    pub->grafo = malloc(sizeof(Grafo));
+    if (pub->grafo == NULL) {
+        perror("Erro na alocação do grafo");
+        return 0;
+    }
+    inicializarGrafo(pub->grafo);
+    return 1;
+}
+
+/// <summary>
+/// Publica a primeira versão da cópia de trabalho ou, se falhar, liberta-a.
+/// </summary>
+static int publicarPrimeiraVersao(GrafoPublicado* pub, int carregado) {
+    if (!carregado || !publicarGrafo(pub)) {
+        libertarGrafo(pub->grafo);
+        free(pub->grafo);
+        pub->grafo = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/// <summary>
+/// Carrega o grafo de um ficheiro de mapa e publica a primeira versão.
+/// </summary>
+/// <param name="pub">Grafo publicado a inicializar.</param>
+/// <param name="ficheiro">Nome do ficheiro de mapa.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int iniciarGrafoPublicado(GrafoPublicado* pub, const char* ficheiro) {
+    if (!prepararGrafoPublicado(pub)) return 0;
+    return publicarPrimeiraVersao(pub, carregarGrafoDeMapa(pub->grafo, ficheiro));
+}
+
+/// <summary>
+/// Cria o grafo a partir de um mapa de frequências já lido e publica a primeira versão.
+/// Ao contrário de carregarGrafoDeMapa, não depende do comprimento das linhas do ficheiro;
+/// as coordenadas passam a começar em 0, como no grafo carregado do ficheiro.
+/// </summary>
+/// <param name="pub">Grafo publicado a inicializar.</param>
+/// <param name="mapa">Mapa de frequências com as antenas (no máximo MAX_VERTICES).</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro ou se o mapa tiver demasiadas antenas.</returns>
+int iniciarGrafoPublicadoDeMapa(GrafoPublicado* pub, const MapaFrequencias* mapa) {
+    if (mapa->totalAntenas > MAX_VERTICES) {
+        printf("O mapa tem %d antenas, mais do que o limite de %d vertices do grafo.\n", mapa->totalAntenas, MAX_VERTICES);
+        return 0;
+    }
+    if (!prepararGrafoPublicado(pub)) return 0;
+
+    int carregado = 1;
+    for (int f = 0; f < NUM_FREQUENCIAS && carregado; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total && carregado; i++) {
+            carregado = inserirVertice(pub->grafo, (char)f, grupo->pontos[i].x - 1, grupo->pontos[i].y - 1);
+        }
+    }
+    if (carregado) criarArestasPorFrequencia(pub->grafo);
+    return publicarPrimeiraVersao(pub, carregado);
+}
+
+/// <summary>
+/// Adiciona uma antena e publica a nova versão do grafo. Os leitores que já estejam a ler
+/// continuam a ver a versão anterior até saírem.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+/// <param name="freq">Frequência da antena.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>1 se a antena foi adicionada e publicada, 0 caso contrário.</returns>
+int adicionarAntenaPublicada(GrafoPublicado* pub, char freq, int x, int y) {
+    if (adicionarAntenaGrafo(pub->grafo, freq, x, y) == -1) return 0;
+    return publicarGrafo(pub);
+}
+
+/// <summary>
+/// Remove uma antena e publica a nova versão do grafo.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>1 se a antena foi removida e publicada, 0 caso contrário.</returns>
+int removerAntenaPublicada(GrafoPublicado* pub, int x, int y) {
+    if (!removerAntenaGrafo(pub->grafo, x, y)) return 0;
+    return publicarGrafo(pub);
+}
+
+/// <summary>
+/// Liberta o grafo de trabalho e todas as versões publicadas. Só pode ser chamada depois
+/// de todos os leitores terminarem.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+void terminarGrafoPublicado(GrafoPublicado* pub) {
+    libertarGrafoImutavel(atomic_exchange(&pub->atual, NULL));
+    while (pub->retirados != NULL) {
+        GrafoImutavel* s = pub->retirados;
+        pub->retirados = s->seguinteRetirado;
+        libertarGrafoImutavel(s);
+    }
+    if (pub->grafo != NULL) {
+        libertarGrafo(pub->grafo);
+        free(pub->grafo);
+        pub->grafo = NULL;
+    }
+}
+
+#pragma endregion
+
+#pragma region Leitores
+
+/// <summary>
+/// Reserva uma posição de leitor para a thread que chama. Cada thread de leitura usa a sua posição.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+/// <returns>Identificador do leitor, ou -1 se já houver MAX_LEITORES leitores.</returns>
+int registarLeitor(GrafoPublicado* pub) {
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        int livre = 0;
+        if (atomic_compare_exchange_strong(&pub->leitores[i].ocupado, &livre, 1)) return i;
+    }
+    return -1;
+}
+
+/// <summary>
+/// Liberta a posição de um leitor.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+/// <param name="leitor">Identificador devolvido por registarLeitor.</param>
+void retirarLeitor(GrafoPublicado* pub, int leitor) {
+    atomic_store(&pub->leitores[leitor].epoca, 0);
+    atomic_store(&pub->leitores[leitor].ocupado, 0);
+}
+
+/// <summary>
+/// Anuncia a época atual e obtém a versão publicada do grafo. A versão obtida permanece válida
+/// até sairLeitura, mesmo que o escritor publique entretanto outra.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+/// <param name="leitor">Identificador do leitor.</param>
+/// <returns>Versão imutável do grafo para consulta.</returns>
+const GrafoImutavel* entrarLeitura(GrafoPublicado* pub, int leitor) {
+    atomic_store(&pub->leitores[leitor].epoca, atomic_load(&pub->epocaGlobal));
+    return atomic_load(&pub->atual);
+}
+
+/// <summary>
+/// Indica que o leitor deixou de usar a versão obtida em entrarLeitura.
+/// </summary>
+/// <param name="pub">Grafo publicado.</param>
+/// <param name="leitor">Identificador do leitor.</param>
+void sairLeitura(GrafoPublicado* pub, int leitor) {
+    atomic_store(&pub->leitores[leitor].epoca, 0);
+}
+
+#pragma endregion
+
+#pragma region Consultas
+
+/// <summary>
+/// Procura o índice do vértice com as coordenadas indicadas numa versão imutável.
+/// </summary>
+/// <param name="s">Versão do grafo.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>Índice do vértice, ou -1 se não existir.</returns>
+int procurarIndiceImutavel(const GrafoImutavel* s, int x, int y) {
+    int pos = posicaoImutavel(x, y, s->capacidadeTabela);
+    for (int v = s->tabelaCoord[pos]; v != -1; v = s->tabelaCoord[pos]) {
+        if (s->posicoes[v].x == x && s->posicoes[v].y == y) return v;
+        pos = (pos + 1) & (s->capacidadeTabela - 1);
+    }
+    return -1;
+}
+
+/// <summary>
+/// Procura em largura (BFS) numa versão imutável, sem escrever no ecrã.
+/// Visita os vértices pela mesma ordem que bfs no grafo de origem.
+/// </summary>
+/// <param name="s">Versão do grafo.</param>
+/// <param name="origem">Índice do vértice de origem.</param>
+/// <param name="ordem">Vetor com pelo menos s->tamanho posições, onde fica a ordem de visita.</param>
+/// <returns>Número de vértices visitados (0 se a origem for inválida).</returns>
+int bfsImutavel(const GrafoImutavel* s, int origem, int* ordem) {
+    char visitado[MAX_VERTICES] = { 0 };
+    int inicio = 0, fim = 0;
+    if (origem < 0 || origem >= s->tamanho) return 0;
+
+    ordem[fim++] = origem;
+    visitado[origem] = 1;
+    while (inicio < fim) {
+        int atual = ordem[inicio++];
+        for (int k = s->inicioAdjacentes[atual]; k < s->inicioAdjacentes[atual + 1]; k++) {
+            int destino = s->adjacentes[k];
+            if (!visitado[destino]) {
+                visitado[destino] = 1;
+                ordem[fim++] = destino;
+            }
+        }
+    }
+    return fim;
+}
+
+/// <summary>
+/// Verifica se existe caminho entre dois vértices de uma versão imutável (mesma componente ligada).
+/// </summary>
+/// <param name="s">Versão do grafo.</param>
+/// <param name="origem">Índice do vértice de origem.</param>
+/// <param name="destino">Índice do vértice de destino.</param>
+/// <returns>1 se existir caminho, 0 caso contrário (ou se algum índice for inválido).</returns>
+int alcancavelImutavel(const GrafoImutavel* s, int origem, int destino) {
+    if (origem < 0 || origem >= s->tamanho || destino < 0 || destino >= s->tamanho) return 0;
+    return s->componente[origem] == s->componente[destino];
+}
+
+/// <summary>
+/// Calcula um caminho com o menor número de ligações entre dois vértices de uma versão imutável.
+/// </summary>
+/// <param name="s">Versão do grafo.</param>
+/// <param name="origem">Índice do vértice de origem.</param>
+/// <param name="destino">Índice do vértice de destino.</param>
+/// <param name="caminho">Vetor com pelo menos s->tamanho posições, onde ficam os vértices do caminho.</param>
+/// <returns>Número de vértices do caminho (0 se não existir).</returns>
+int caminhoImutavel(const GrafoImutavel* s, int origem, int destino, int* caminho) {
+    int anterior[MAX_VERTICES];
+    int fila[MAX_VERTICES];
+    int inicio = 0, fim = 0;
+    if (!alcancavelImutavel(s, origem, destino)) return 0;
+
+    for (int v = 0; v < s->tamanho; v++) anterior[v] = -2;
+    fila[fim++] = origem;
+    anterior[origem] = -1;
+    while (inicio < fim && anterior[destino] == -2) {
+        int atual = fila[inicio++];
+        for (int a = s->inicioAdjacentes[atual]; a < s->inicioAdjacentes[atual + 1]; a++) {
+            if (anterior[s->adjacentes[a]] == -2) {
+                anterior[s->adjacentes[a]] = atual;
+                fila[fim++] = s->adjacentes[a];
+            }
+        }
+    }
+
+    // Reconstrói o caminho do destino para a origem e inverte-o
+    int total = 0;
+    for (int v = destino; v != -1; v = anterior[v]) caminho[total++] = v;
+    for (int i = 0, j = total - 1; i < j; i++, j--) {
+        int temp = caminho[i];
+        caminho[i] = caminho[j];
+        caminho[j] = temp;
+    }
+    return total;
+}
+
+/// <summary>
+/// Conta os pares de antenas de frequência freqA e freqB a uma distância não superior a distMax,
+/// como listarIntersecoesEntreFrequencias, mas percorrendo apenas os vértices das duas frequências.
+/// </summary>
+/// <param name="s">Versão do grafo.</param>
+/// <param name="freqA">Primeira frequência.</param>
+/// <param name="freqB">Segunda frequência.</param>
+/// <param name="distMax">Distância máxima.</param>
+/// <param name="pares">Vetor opcional (pode ser NULL) com 2 * maxPares posições para os índices dos pares.</param>
+/// <param name="maxPares">Número máximo de pares a guardar.</param>
+/// <returns>Número total de pares encontrados.</returns>
+int intersecoesImutavel(const GrafoImutavel* s, char freqA, char freqB, float distMax, int* pares, int maxPares) {
+    int fa = (unsigned char)freqA, fb = (unsigned char)freqB;
+    int total = 0;
+
+    for (int a = s->inicioFrequencia[fa]; a < s->inicioFrequencia[fa + 1]; a++) {
+        int i = s->porFrequencia[a];
+        for (int b = s->inicioFrequencia[fb]; b < s->inicioFrequencia[fb + 1]; b++) {
+            int j = s->porFrequencia[b];
+            int dx = s->posicoes[i].x - s->posicoes[j].x;
+            int dy = s->posicoes[i].y - s->posicoes[j].y;
+            float dist = sqrt((float)(dx * dx + dy * dy));
+
+            if (dist <= distMax) {
+                if (pares != NULL && total < maxPares) {
+                    pares[2 * total] = i;
+                    pares[2 * total + 1] = j;
+                }
+                total++;
+            }
+        }
+    }
+    return total;
+}
+
+#pragma endregion
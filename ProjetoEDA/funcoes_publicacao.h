@@ -0,0 +1,36 @@
+/*
+ *  @file funcoes_publicacao.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-30
+ *  @project EDA
+ *
+ *  Declarao das funes de publicao do grafo para leitura concorrente: cpias imutveis
+ *  trocadas atomicamente pelo escritor e consultas sem trincos pelos leitores.
+ */
+
+#ifndef FUNCOES_PUBLICACAO_H
+#define FUNCOES_PUBLICACAO_H
+
+#include "dados.h"
+
+// Publicao (apenas uma thread escritora)
+int iniciarGrafoPublicado(GrafoPublicado* pub, const char* ficheiro);
+int iniciarGrafoPublicadoDeMapa(GrafoPublicado* pub, const MapaFrequencias* mapa);
+int adicionarAntenaPublicada(GrafoPublicado* pub, char freq, int x, int y);
+int removerAntenaPublicada(GrafoPublicado* pub, int x, int y);
+void terminarGrafoPublicado(GrafoPublicado* pub);
+
+// Leitores
+int registarLeitor(GrafoPublicado* pub);
+void retirarLeitor(GrafoPublicado* pub, int leitor);
+const GrafoImutavel* entrarLeitura(GrafoPublicado* pub, int leitor);
+void sairLeitura(GrafoPublicado* pub, int leitor);
+
+// Consultas sobre uma cpia imutvel
+int procurarIndiceImutavel(const GrafoImutavel* s, int x, int y);
+int bfsImutavel(const GrafoImutavel* s, int origem, int* ordem);
+int alcancavelImutavel(const GrafoImutavel* s, int origem, int destino);
+int caminhoImutavel(const GrafoImutavel* s, int origem, int destino, int* caminho);
+int intersecoesImutavel(const GrafoImutavel* s, char freqA, char freqB, float distMax, int* pares, int maxPares);
+
+#endif // FUNCOES_PUBLICACAO_H
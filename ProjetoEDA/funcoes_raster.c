@@ -0,0 +1,642 @@
+﻿/*
+ *  @file funcoes_raster.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-02
+ *  @project EDA
+ *
+ *  Implementação da representação compacta da matriz de antenas e nefastos:
+ *  um bit por célula para os nefastos e uma lista esparsa de antenas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "funcoes.h"
+#include "funcoes_bits.h"
+#include "funcoes_raster.h"
+
+#define BLOCO_NEFASTOS_INDICE 4096   // Capacidade inicial do vetor de simétricos do índice de nefastos
+
+/// <summary>
+/// Antena colocada no raster, usada apenas para ordenar as antenas por célula.
+/// </summary>
+typedef struct {
+    int64_t celula;
+    char freq;
+} AntenaRaster;
+
+/// <summary>
+/// Compara duas antenas do raster pelo índice da célula (para qsort).
+/// </summary>
+static int compararAntenasRaster(const void* a, const void* b) {
+    int64_t ca = ((const AntenaRaster*)a)->celula;
+    int64_t cb = ((const AntenaRaster*)b)->celula;
+    return (ca > cb) - (ca < cb);
+}
+
+/// <summary>
+/// Calcula o índice da célula (em coordenadas do mapa) no raster, ou -1 se estiver fora dos limites.
+/// </summary>
+static int64_t indiceCelulaRaster(const RasterCompacto* raster, int x, int y) {
+    int linha = x - raster->minX;
+    int coluna = y - raster->minY;
+    if (linha < 0 || linha >= raster->nRows || coluna < 0 || coluna >= raster->nCols)
+        return -1;
+    return (int64_t)linha * raster->nCols + coluna;
+}
+
+/// <summary>
+/// Procura a primeira antena do raster com índice de célula maior ou igual ao indicado.
+/// </summary>
+static int primeiraAntenaRaster(const RasterCompacto* raster, int64_t celula) {
+    int inicio = 0, fim = raster->totalAntenas;
+    while (inicio < fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        if (raster->celulas[meio] < celula)
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+    return inicio;
+}
+
+/// <summary>
+/// Reserva o mapa de bits e a lista de antenas de um raster cujos limites já estão definidos
+/// e coloca as antenas, ordenadas pelo índice da célula para permitir pesquisa binária.
+/// </summary>
+static int prepararRaster(const MapaFrequencias* mapa, RasterCompacto* raster) {
+    raster->totalAntenas = mapa->totalAntenas;
+
+    int64_t totalCelulas = (int64_t)raster->nRows * raster->nCols;
+    raster->nefastos = calloc((size_t)((totalCelulas + 63) / 64), sizeof(uint64_t));
+    raster->celulas = malloc(mapa->totalAntenas * sizeof(int64_t));
+    raster->freqs = malloc(mapa->totalAntenas * sizeof(char));
+    AntenaRaster* antenas = malloc(mapa->totalAntenas * sizeof(AntenaRaster));
+    if (!raster->nefastos || !raster->celulas || !raster->freqs || !antenas) {
+        free(antenas);
+        libertarRasterCompacto(raster);
+        return 0;
+    }
+
+    int n = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            antenas[n].celula = indiceCelulaRaster(raster, grupo->pontos[i].x, grupo->pontos[i].y);
+            antenas[n].freq = (char)f;
+            n++;
+        }
+    }
+    qsort(antenas, n, sizeof(AntenaRaster), compararAntenasRaster);
+    for (int i = 0; i < n; i++) {
+        raster->celulas[i] = antenas[i].celula;
+        raster->freqs[i] = antenas[i].freq;
+    }
+    free(antenas);
+    return 1;
+}
+
+/// <summary>
+/// Cria a representação compacta da matriz de antenas e nefastos de um mapa, sem escrever mensagens
+/// (pode ser usada em paralelo com mapas diferentes; ver criarRasterCompacto).
+/// Os limites são os mesmos de criarMatrizComNefastos; cada par de antenas da mesma frequência
+/// marca os seus dois simétricos no mapa de bits, pelo que não é preciso verificar repetidos.
+/// </summary>
+/// <param name="mapa">Mapa de frequências com as antenas.</param>
+/// <param name="raster">Estrutura onde é guardada a representação compacta.</param>
+/// <returns>1 em caso de sucesso, 0 se o mapa não tiver antenas, -1 em caso de erro de alocação.</returns>
+int construirRasterCompacto(const MapaFrequencias* mapa, RasterCompacto* raster) {
+    memset(raster, 0, sizeof(RasterCompacto));
+    if (mapa->totalAntenas == 0) return 0;
+
+    int maxX, maxY;
+    calcularLimitesMapa(mapa, &raster->minX, &maxX, &raster->minY, &maxY);
+    raster->nRows = maxX - raster->minX + 1;
+    raster->nCols = maxY - raster->minY + 1;
+    if (!prepararRaster(mapa, raster)) return -1;
+
+    // Marca os simétricos de cada par de antenas da mesma frequência
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            const Coordenada* p = &grupo->pontos[i];
+            for (int j = i + 1; j < grupo->total; j++) {
+                const Coordenada* q = &grupo->pontos[j];
+                int64_t c1 = indiceCelulaRaster(raster, 2 * q->x - p->x, 2 * q->y - p->y);
+                int64_t c2 = indiceCelulaRaster(raster, 2 * p->x - q->x, 2 * p->y - q->y);
+                raster->nefastos[c1 >> 6] |= (uint64_t)1 << (c1 & 63);
+                raster->nefastos[c2 >> 6] |= (uint64_t)1 << (c2 & 63);
+            }
+        }
+    }
+
+    return 1;
+}
+
+/// <summary>
+/// Cria a representação compacta da matriz de antenas e nefastos de um mapa (ver construirRasterCompacto),
+/// apresentando uma mensagem em caso de erro.
+/// </summary>
+/// <param name="mapa">Mapa de frequências com as antenas.</param>
+/// <param name="raster">Estrutura onde é guardada a representação compacta.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int criarRasterCompacto(const MapaFrequencias* mapa, RasterCompacto* raster) {
+    int resultado = construirRasterCompacto(mapa, raster);
+    if (resultado == 0)
+        printf("Lista de antenas vazia. Sem dados para criar o raster.\n");
+    else if (resultado < 0)
+        perror("Erro na alocação do raster");
+    return resultado == 1;
+}
+
+/// <summary>
+/// Cria a representação compacta a partir de uma lista de antenas, como criarMatrizComNefastos,
+/// convertendo primeiro a lista num mapa de frequências.
+/// </summary>
+/// <param name="lista">Lista de antenas.</param>
+/// <param name="raster">Estrutura onde é guardada a representação compacta.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int criarRasterDeAntenas(const Antena* lista, RasterCompacto* raster) {
+    MapaFrequencias* mapa = malloc(sizeof(MapaFrequencias));
+    if (!mapa) {
+        perror("Erro na alocação do mapa");
+        return 0;
+    }
+    inicializarMapaFrequencias(mapa);
+
+    int sucesso = 0;
+    if (!converterAntenasParaMapa(lista, mapa))
+        perror("Erro na alocação do mapa");
+    else
+        sucesso = criarRasterCompacto(mapa, raster);
+
+    libertarMapaFrequencias(mapa);
+    free(mapa);
+    return sucesso;
+}
+
+/// <summary>
+/// Calcula o máximo divisor comum de dois inteiros não negativos.
+/// </summary>
+static int maximoDivisorComum(int a, int b) {
+    while (b != 0) {
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/// <summary>
+/// Marca no mapa de bits a reta que passa por duas antenas, percorrendo-a com o passo reduzido pelo m.d.c.
+/// Em vez de verificar cada ponto, calcula o intervalo de múltiplos t do passo que ficam dentro do mapa
+/// e avança no índice da célula com um salto constante.
+/// </summary>
+/// <param name="raster">Raster onde são marcados os nefastos.</param>
+/// <param name="p">Primeira antena.</param>
+/// <param name="q">Segunda antena.</param>
+static void marcarRetaHarmonica(RasterCompacto* raster, const Coordenada* p, const Coordenada* q) {
+    int dx = q->x - p->x, dy = q->y - p->y;
+    int mdc = maximoDivisorComum(dx < 0 ? -dx : dx, dy < 0 ? -dy : dy);
+    if (mdc == 0) return; // Antenas repetidas não definem uma reta
+    int passoX = dx / mdc, passoY = dy / mdc;
+    int linha = p->x - raster->minX, coluna = p->y - raster->minY;
+
+    // Intervalo de t (a antena p está em t = 0) em que linha + t * passoX e coluna + t * passoY ficam no mapa
+    int tMin = INT_MIN, tMax = INT_MAX;
+    if (passoX > 0) {
+        tMin = -(linha / passoX);
+        tMax = (raster->nRows - 1 - linha) / passoX;
+    }
+    else if (passoX < 0) {
+        tMin = -((raster->nRows - 1 - linha) / -passoX);
+        tMax = linha / -passoX;
+    }
+    if (passoY > 0) {
+        if (-(coluna / passoY) > tMin) tMin = -(coluna / passoY);
+        if ((raster->nCols - 1 - coluna) / passoY < tMax) tMax = (raster->nCols - 1 - coluna) / passoY;
+    }
+    else if (passoY < 0) {
+        if (-((raster->nCols - 1 - coluna) / -passoY) > tMin) tMin = -((raster->nCols - 1 - coluna) / -passoY);
+        if (coluna / -passoY < tMax) tMax = coluna / -passoY;
+    }
+
+    int64_t salto = (int64_t)passoX * raster->nCols + passoY;
+    int64_t celula = (int64_t)linha * raster->nCols + coluna + tMin * salto;
+    for (int t = tMin; t <= tMax; t++, celula += salto) {
+        raster->nefastos[celula >> 6] |= (uint64_t)1 << (celula & 63);
+    }
+}
+
+/// <summary>
+/// Cria a representação compacta no modo harmónico: cada par de antenas da mesma frequência torna
+/// nefastas todas as células da reta que passa pelas duas antenas (incluindo as próprias antenas),
+/// em múltiplos inteiros do passo reduzido pelo m.d.c., dentro dos limites do mapa lido do ficheiro.
+/// As retas são escritas diretamente no mapa de bits.
+/// </summary>
+/// <param name="mapa">Mapa de frequências com as antenas.</param>
+/// <param name="raster">Estrutura onde é guardada a representação compacta.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int criarRasterHarmonico(const MapaFrequencias* mapa, RasterCompacto* raster) {
+    memset(raster, 0, sizeof(RasterCompacto));
+    if (mapa->totalAntenas == 0) {
+        printf("Lista de antenas vazia. Sem dados para criar o raster.\n");
+        return 0;
+    }
+    if (mapa->nLinhas <= 0 || mapa->nColunas <= 0) {
+        printf("Dimensões do mapa inválidas: nLinhas=%d, nColunas=%d\n", mapa->nLinhas, mapa->nColunas);
+        return 0;
+    }
+
+    raster->minX = 1;
+    raster->minY = 1;
+    raster->nRows = mapa->nLinhas;
+    raster->nCols = mapa->nColunas;
+    if (!prepararRaster(mapa, raster)) {
+        perror("Erro na alocação do raster");
+        return 0;
+    }
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            for (int j = i + 1; j < grupo->total; j++) {
+                marcarRetaHarmonica(raster, &grupo->pontos[i], &grupo->pontos[j]);
+            }
+        }
+    }
+
+    return 1;
+}
+
+/// <summary>
+/// Liberta toda a memória ocupada pela representação compacta.
+/// </summary>
+/// <param name="raster">Raster a libertar.</param>
+void libertarRasterCompacto(RasterCompacto* raster) {
+    free(raster->nefastos);
+    free(raster->celulas);
+    free(raster->freqs);
+    memset(raster, 0, sizeof(RasterCompacto));
+}
+
+/// <summary>
+/// Verifica se uma célula (em coordenadas do mapa) tem efeito nefasto, mesmo que lá esteja uma antena.
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>1 se for nefasto, 0 caso contrário ou se estiver fora dos limites.</returns>
+int existeNefastoRaster(const RasterCompacto* raster, int x, int y) {
+    int64_t celula = indiceCelulaRaster(raster, x, y);
+    if (celula < 0) return 0;
+    return (int)((raster->nefastos[celula >> 6] >> (celula & 63)) & 1);
+}
+
+/// <summary>
+/// Devolve o carácter que a matriz completa teria numa célula (em coordenadas do mapa):
+/// a frequência da antena, '#' para um nefasto ou '.' para uma célula vazia.
+/// A antena é procurada por pesquisa binária na lista esparsa.
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>Carácter da célula ('.' se estiver fora dos limites).</returns>
+char consultarCelulaRaster(const RasterCompacto* raster, int x, int y) {
+    int64_t celula = indiceCelulaRaster(raster, x, y);
+    if (celula < 0) return '.';
+
+    int i = primeiraAntenaRaster(raster, celula);
+    if (i < raster->totalAntenas && raster->celulas[i] == celula)
+        return raster->freqs[i];
+    return ((raster->nefastos[celula >> 6] >> (celula & 63)) & 1) ? '#' : '.';
+}
+
+/// <summary>
+/// Reconstrói uma linha da matriz como texto. Só os bits a 1 das palavras da linha são visitados
+/// e as antenas da linha são sobrepostas no fim.
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <param name="linha">Índice da linha (0 a nRows - 1).</param>
+/// <param name="destino">Vetor com pelo menos nCols + 1 posições.</param>
+void descodificarLinhaRaster(const RasterCompacto* raster, int linha, char* destino) {
+    int64_t inicio = (int64_t)linha * raster->nCols;
+    int64_t fim = inicio + raster->nCols;
+
+    memset(destino, '.', raster->nCols);
+    destino[raster->nCols] = '\0';
+
+    for (int64_t w = inicio >> 6; w <= (fim - 1) >> 6; w++) {
+        uint64_t bits = raster->nefastos[w];
+        // Descarta os bits das linhas vizinhas que partilham a primeira ou a última palavra
+        if (w == inicio >> 6)
+            bits &= ~(uint64_t)0 << (inicio & 63);
+        if (w == (fim - 1) >> 6 && (fim & 63) != 0)
+            bits &= ~(~(uint64_t)0 << (fim & 63));
+
+        while (bits != 0) {
+            destino[w * 64 + bitMenosSignificativo(bits) - inicio] = '#';
+            bits &= bits - 1; // Limpa o bit menos significativo
+        }
+    }
+
+    for (int i = primeiraAntenaRaster(raster, inicio); i < raster->totalAntenas && raster->celulas[i] < fim; i++) {
+        destino[raster->celulas[i] - inicio] = raster->freqs[i];
+    }
+}
+
+/// <summary>
+/// Conta as células com efeito nefasto (incluindo as que têm uma antena por cima),
+/// o que corresponde ao número de elementos da lista de calcularNefastos.
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <returns>Número de células nefastas.</returns>
+int64_t contarNefastosRaster(const RasterCompacto* raster) {
+    int64_t totalPalavras = ((int64_t)raster->nRows * raster->nCols + 63) / 64;
+    int64_t total = 0;
+    for (int64_t w = 0; w < totalPalavras; w++) {
+        for (uint64_t bits = raster->nefastos[w]; bits != 0; bits &= bits - 1) {
+            total++;
+        }
+    }
+    return total;
+}
+
+/// <summary>
+/// Imprime a matriz representada pelo raster, linha a linha, usando um único vetor auxiliar.
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <param name="saida">Ficheiro onde é escrita a matriz (por exemplo, stdout).</param>
+void imprimirRasterCompacto(const RasterCompacto* raster, FILE* saida) {
+    if (raster->nRows <= 0) {
+        printf("Raster vazio.\n");
+        return;
+    }
+    char* linha = malloc((size_t)raster->nCols + 1);
+    if (!linha) {
+        perror("Erro na alocação de uma linha do raster");
+        return;
+    }
+    for (int l = 0; l < raster->nRows; l++) {
+        descodificarLinhaRaster(raster, l, linha);
+        fprintf(saida, "%s\n", linha);
+    }
+    free(linha);
+}
+
+/// <summary>
+/// Calcula a memória ocupada pelos dados do raster compacto (mapa de bits e antenas).
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <returns>Número de bytes ocupados.</returns>
+size_t memoriaRasterCompacto(const RasterCompacto* raster) {
+    int64_t totalCelulas = (int64_t)raster->nRows * raster->nCols;
+    return sizeof(RasterCompacto)
+        + (size_t)((totalCelulas + 63) / 64) * sizeof(uint64_t)
+        + (size_t)raster->totalAntenas * (sizeof(int64_t) + sizeof(char));
+}
+
+/// <summary>
+/// Calcula a memória que a matriz char** de criarMatrizComNefastos ocuparia para os mesmos limites.
+/// </summary>
+/// <param name="raster">Raster compacto.</param>
+/// <returns>Número de bytes ocupados pela matriz equivalente.</returns>
+size_t memoriaMatrizEquivalente(const RasterCompacto* raster) {
+    return (size_t)raster->nRows * (sizeof(char*) + (size_t)raster->nCols + 1);
+}
+
+/// <summary>
+/// Ponto com frequência, usado apenas para ordenar as antenas ao criar o índice espacial.
+/// </summary>
+typedef struct {
+    Coordenada c;
+    char freq;
+} PontoIndice;
+
+/// <summary>
+/// Compara dois pontos por linha e depois por coluna (para qsort).
+/// </summary>
+static int compararPontosIndice(const void* a, const void* b) {
+    const Coordenada* ca = &((const PontoIndice*)a)->c;
+    const Coordenada* cb = &((const PontoIndice*)b)->c;
+    if (ca->x != cb->x) return (ca->x < cb->x) ? -1 : 1;
+    return (ca->y > cb->y) - (ca->y < cb->y);
+}
+
+/// <summary>
+/// Compara duas coordenadas por linha e depois por coluna (para qsort).
+/// </summary>
+static int compararCoordenadasIndice(const void* a, const void* b) {
+    const Coordenada* ca = (const Coordenada*)a;
+    const Coordenada* cb = (const Coordenada*)b;
+    if (ca->x != cb->x) return (ca->x < cb->x) ? -1 : 1;
+    return (ca->y > cb->y) - (ca->y < cb->y);
+}
+
+/// <summary>
+/// Cria o índice espacial das antenas de um mapa, ordenado por linha e coluna.
+/// </summary>
+/// <param name="mapa">Mapa de frequências com as antenas.</param>
+/// <param name="indice">Índice a preencher.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int criarIndiceAntenas(const MapaFrequencias* mapa, IndiceEspacial* indice) {
+    indice->total = 0;
+    indice->pontos = malloc((mapa->totalAntenas + 1) * sizeof(Coordenada));
+    indice->freqs = malloc((mapa->totalAntenas + 1) * sizeof(char));
+    PontoIndice* temp = malloc((mapa->totalAntenas + 1) * sizeof(PontoIndice));
+    if (!indice->pontos || !indice->freqs || !temp) {
+        perror("Erro na alocação do índice de antenas");
+        free(temp);
+        libertarIndiceEspacial(indice);
+        return 0;
+    }
+
+    int n = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            temp[n].c = grupo->pontos[i];
+            temp[n].freq = (char)f;
+            n++;
+        }
+    }
+    qsort(temp, n, sizeof(PontoIndice), compararPontosIndice);
+    for (int i = 0; i < n; i++) {
+        indice->pontos[i] = temp[i].c;
+        indice->freqs[i] = temp[i].freq;
+    }
+    indice->total = n;
+
+    free(temp);
+    return 1;
+}
+
+/// <summary>
+/// Ordena um vetor de coordenadas por linha e coluna e elimina os repetidos.
+/// </summary>
+/// <param name="pontos">Vetor de coordenadas.</param>
+/// <param name="n">Número de coordenadas do vetor.</param>
+/// <returns>Número de coordenadas distintas, que ficam no início do vetor.</returns>
+size_t ordenarCoordenadasSemRepetidos(Coordenada* pontos, size_t n) {
+    if (n == 0) return 0;
+    qsort(pontos, n, sizeof(Coordenada), compararCoordenadasIndice);
+    size_t unicos = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unicos == 0 || pontos[i].x != pontos[unicos - 1].x || pontos[i].y != pontos[unicos - 1].y) {
+            pontos[unicos++] = pontos[i];
+        }
+    }
+    return unicos;
+}
+
+/// <summary>
+/// Cria o índice espacial dos nefastos de um mapa. Os simétricos são acumulados num vetor que,
+/// sempre que fica cheio, é ordenado e limpo de repetidos; só cresce quando mais de metade das
+/// posições são nefastos distintos. Assim, a memória usada é proporcional ao número de nefastos
+/// distintos (mais um bloco fixo) e não ao número de pares de antenas.
+/// </summary>
+/// <param name="mapa">Mapa de frequências com as antenas.</param>
+/// <param name="indice">Índice a preencher.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int criarIndiceNefastos(const MapaFrequencias* mapa, IndiceEspacial* indice) {
+    size_t capacidade = BLOCO_NEFASTOS_INDICE, n = 0;
+    indice->total = 0;
+    indice->freqs = NULL;
+    indice->pontos = malloc(capacidade * sizeof(Coordenada));
+    if (!indice->pontos) {
+        perror("Erro na alocação do índice de nefastos");
+        return 0;
+    }
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const GrupoFrequencia* grupo = &mapa->grupos[f];
+        for (int i = 0; i < grupo->total; i++) {
+            for (int j = 0; j < grupo->total; j++) {
+                if (i == j) continue;
+                if (n == capacidade) {
+                    n = ordenarCoordenadasSemRepetidos(indice->pontos, n);
+                    if (n > INT_MAX) {
+                        printf("Demasiados nefastos para o índice (mais de %d).\n", INT_MAX);
+                        libertarIndiceEspacial(indice);
+                        return 0;
+                    }
+                    if (n > capacidade / 2) {
+                        Coordenada* maior = realloc(indice->pontos, 2 * capacidade * sizeof(Coordenada));
+                        if (!maior) {
+                            perror("Erro na alocação do índice de nefastos");
+                            libertarIndiceEspacial(indice);
+                            return 0;
+                        }
+                        indice->pontos = maior;
+                        capacidade *= 2;
+                    }
+                }
+                // Simétrico de i em relação a j
+                indice->pontos[n].x = 2 * grupo->pontos[j].x - grupo->pontos[i].x;
+                indice->pontos[n].y = 2 * grupo->pontos[j].y - grupo->pontos[i].y;
+                n++;
+            }
+        }
+    }
+
+    n = ordenarCoordenadasSemRepetidos(indice->pontos, n);
+    if (n > INT_MAX) {
+        printf("Demasiados nefastos para o índice (mais de %d).\n", INT_MAX);
+        libertarIndiceEspacial(indice);
+        return 0;
+    }
+    indice->total = (int)n;
+    return 1;
+}
+
+/// <summary>
+/// Liberta a memória ocupada por um índice espacial.
+/// </summary>
+/// <param name="indice">Índice a libertar.</param>
+void libertarIndiceEspacial(IndiceEspacial* indice) {
+    free(indice->pontos);
+    free(indice->freqs);
+    indice->pontos = NULL;
+    indice->freqs = NULL;
+    indice->total = 0;
+}
+
+/// <summary>
+/// Procura no índice o primeiro ponto que não seja anterior a (x, y) na ordem linha/coluna.
+/// </summary>
+/// <param name="indice">Índice espacial.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>Posição do ponto encontrado (ou o total, se não existir).</returns>
+int procurarPontoIndice(const IndiceEspacial* indice, int x, int y) {
+    int inicio = 0, fim = indice->total;
+    while (inicio < fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        const Coordenada* c = &indice->pontos[meio];
+        if (c->x < x || (c->x == x && c->y < y))
+            inicio = meio + 1;
+        else
+            fim = meio;
+    }
+    return inicio;
+}
+
+/// <summary>
+/// Preenche uma janela do mapa com canto superior esquerdo em (x0, y0), com 'rows' linhas e 'cols' colunas.
+/// Em cada linha, as antenas e os nefastos são obtidos por pesquisa binária nos índices,
+/// pelo que o custo depende apenas do tamanho da janela e do número de objetos nela contidos.
+/// As antenas sobrepõem-se aos nefastos, como em criarMatrizComNefastos.
+/// </summary>
+/// <param name="antenas">Índice espacial das antenas.</param>
+/// <param name="nefastos">Índice espacial dos nefastos.</param>
+/// <param name="x0">Linha (coordenada X) do canto superior esquerdo.</param>
+/// <param name="y0">Coluna (coordenada Y) do canto superior esquerdo.</param>
+/// <param name="rows">Número de linhas da janela.</param>
+/// <param name="cols">Número de colunas da janela.</param>
+/// <param name="linhas">Linhas da janela (cada uma com cols + 1 posições).</param>
+void preencherJanela(const IndiceEspacial* antenas, const IndiceEspacial* nefastos,
+    int x0, int y0, int rows, int cols, char** linhas) {
+    for (int l = 0; l < rows; l++) {
+        int x = x0 + l;
+        memset(linhas[l], '.', cols);
+        linhas[l][cols] = '\0';
+
+        for (int i = procurarPontoIndice(nefastos, x, y0);
+            i < nefastos->total && nefastos->pontos[i].x == x && nefastos->pontos[i].y < y0 + cols; i++) {
+            linhas[l][nefastos->pontos[i].y - y0] = '#';
+        }
+        for (int i = procurarPontoIndice(antenas, x, y0);
+            i < antenas->total && antenas->pontos[i].x == x && antenas->pontos[i].y < y0 + cols; i++) {
+            linhas[l][antenas->pontos[i].y - y0] = antenas->freqs[i];
+        }
+    }
+}
+
+/// <summary>
+/// Imprime uma janela do mapa linha a linha, sem criar a matriz completa nem a janela inteira.
+/// </summary>
+/// <param name="antenas">Índice espacial das antenas.</param>
+/// <param name="nefastos">Índice espacial dos nefastos.</param>
+/// <param name="x0">Linha (coordenada X) do canto superior esquerdo.</param>
+/// <param name="y0">Coluna (coordenada Y) do canto superior esquerdo.</param>
+/// <param name="rows">Número de linhas da janela.</param>
+/// <param name="cols">Número de colunas da janela.</param>
+/// <param name="saida">Ficheiro onde é escrita a janela (por exemplo, stdout).</param>
+void imprimirJanela(const IndiceEspacial* antenas, const IndiceEspacial* nefastos,
+    int x0, int y0, int rows, int cols, FILE* saida) {
+    if (rows <= 0 || cols <= 0) {
+        printf("Dimensões de janela inválidas: rows=%d, cols=%d\n", rows, cols);
+        return;
+    }
+    char* linha = malloc((size_t)cols + 1);
+    if (!linha) {
+        perror("Erro na alocação de uma linha da janela");
+        return;
+    }
+    for (int l = 0; l < rows; l++) {
+        preencherJanela(antenas, nefastos, x0 + l, y0, 1, cols, &linha);
+        fprintf(saida, "%s\n", linha);
+    }
+    free(linha);
+}
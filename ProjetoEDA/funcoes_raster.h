@@ -0,0 +1,47 @@
+/*
+ *  @file funcoes_raster.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-02
+ *  @project EDA
+ *
+ *  Declarao das funes da representao compacta da matriz de antenas e nefastos
+ *  e da janela de visualizao baseada em ndices espaciais.
+ */
+
+#ifndef FUNCOES_RASTER_H
+#define FUNCOES_RASTER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "dados.h"
+
+// Criao e libertao
+int construirRasterCompacto(const MapaFrequencias* mapa, RasterCompacto* raster);
+int criarRasterCompacto(const MapaFrequencias* mapa, RasterCompacto* raster);
+int criarRasterDeAntenas(const Antena* lista, RasterCompacto* raster);
+int criarRasterHarmonico(const MapaFrequencias* mapa, RasterCompacto* raster);
+void libertarRasterCompacto(RasterCompacto* raster);
+
+// Consultas
+int existeNefastoRaster(const RasterCompacto* raster, int x, int y);
+char consultarCelulaRaster(const RasterCompacto* raster, int x, int y);
+void descodificarLinhaRaster(const RasterCompacto* raster, int linha, char* destino);
+int64_t contarNefastosRaster(const RasterCompacto* raster);
+
+// Apresentao
+void imprimirRasterCompacto(const RasterCompacto* raster, FILE* saida);
+size_t memoriaRasterCompacto(const RasterCompacto* raster);
+size_t memoriaMatrizEquivalente(const RasterCompacto* raster);
+
+// ndices espaciais e janela de visualizao
+int criarIndiceAntenas(const MapaFrequencias* mapa, IndiceEspacial* indice);
+int criarIndiceNefastos(const MapaFrequencias* mapa, IndiceEspacial* indice);
+size_t ordenarCoordenadasSemRepetidos(Coordenada* pontos, size_t n);
+void libertarIndiceEspacial(IndiceEspacial* indice);
+int procurarPontoIndice(const IndiceEspacial* indice, int x, int y);
+void preencherJanela(const IndiceEspacial* antenas, const IndiceEspacial* nefastos,
+    int x0, int y0, int rows, int cols, char** linhas);
+void imprimirJanela(const IndiceEspacial* antenas, const IndiceEspacial* nefastos,
+    int x0, int y0, int rows, int cols, FILE* saida);
+
+#endif // FUNCOES_RASTER_H
@@ -0,0 +1,518 @@
+﻿/*
+ *  @file funcoes_servidor.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-07
+ *  @project EDA
+ *
+ *  Implementação do servidor de consultas. O mapa é lido uma única vez e ficam prontos o grafo
+ *  publicado, o raster compacto e os índices espaciais. Cada pedido é uma linha de texto e cada
+ *  resposta começa por "OK" ou "ERRO". As coordenadas são as do mapa (linha e coluna a começar em 1).
+ *
+ *  Pedidos:
+ *   CAMINHO x1 y1 x2 y2        -> OK n x y ...          (caminho com menos ligações)
+ *   ALCANCAVEL x1 y1 x2 y2     -> OK 0|1
+ *   INTERSECOES fA fB dist     -> OK n x1 y1 x2 y2 ...  (pares a distância <= dist)
+ *   NEFASTO x y                -> OK 0|1
+ *   JANELA x0 y0 linhas cols   -> OK linhas cols, seguido de uma linha por cada linha da janela
+ *   FIM                        -> OK e fecha a ligação
+ *   DESLIGAR                   -> OK e termina o servidor
+ *
+ *  Os pedidos enviados seguidos (sem esperar pela resposta) são tratados em lote: todas as linhas
+ *  completas recebidas são respondidas com uma única entrada na versão publicada do grafo e as
+ *  respostas são enviadas de uma só vez.
+ */
+
+// lstat e S_ISSOCK, usados para confirmar que o caminho do socket pode ser apagado (tem de vir antes dos includes)
+#ifndef _WIN32
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "funcoes.h"
+#include "funcoes_raster.h"
+#include "funcoes_publicacao.h"
+#include "funcoes_servidor.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET Socket;
+#define SOCKET_INVALIDO INVALID_SOCKET
+#define fecharSocket closesocket
+#else
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int Socket;
+#define SOCKET_INVALIDO (-1)
+#define fecharSocket close
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define OPCOES_ENVIO MSG_NOSIGNAL   // Um cliente que fecha a ligação não deve terminar o servidor
+#else
+#define OPCOES_ENVIO 0
+#endif
+
+#define TAM_BUFFER_PEDIDOS 65536
+#define TAM_MAX_PEDIDO 256
+#define TAM_MAX_JANELA 4096
+
+#pragma region Estado do Servidor
+
+/// <summary>
+/// Carrega o mapa uma única vez e prepara as estruturas usadas para responder aos pedidos.
+/// O grafo é criado a partir do mapa de frequências, pelo que as linhas podem ter qualquer comprimento;
+/// se o mapa tiver mais de MAX_VERTICES antenas, o grafo fica indisponível e os pedidos que dele
+/// dependem (CAMINHO, ALCANCAVEL e INTERSECOES) são respondidos com erro.
+/// </summary>
+/// <param name="estado">Estado a preencher.</param>
+/// <param name="ficheiro">Nome do ficheiro de mapa.</param>
+/// <returns>1 em caso de sucesso, 0 em caso de erro.</returns>
+int carregarEstadoServidor(EstadoServidor* estado, const char* ficheiro) {
+    memset(&estado->raster, 0, sizeof(RasterCompacto));
+    memset(&estado->antenas, 0, sizeof(IndiceEspacial));
+    memset(&estado->nefastos, 0, sizeof(IndiceEspacial));
+    estado->grafoDisponivel = 0;
+    estado->leitor = -1;
+    estado->totalPedidos = 0;
+
+    MapaFrequencias* mapa = malloc(sizeof(MapaFrequencias));
+    if (mapa == NULL) {
+        perror("Erro na alocação do mapa");
+        return 0;
+    }
+    inicializarMapaFrequencias(mapa);
+    int sucesso = carregarMapaFrequencias(ficheiro, mapa)
+        && (mapa->totalAntenas == 0 || criarRasterCompacto(mapa, &estado->raster))
+        && criarIndiceAntenas(mapa, &estado->antenas)
+        && criarIndiceNefastos(mapa, &estado->nefastos);
+
+    if (sucesso && mapa->totalAntenas <= MAX_VERTICES) {
+        sucesso = iniciarGrafoPublicadoDeMapa(&estado->grafo, mapa);
+        if (sucesso) {
+            estado->leitor = registarLeitor(&estado->grafo);
+            if (estado->leitor == -1) {
+                printf("Sem posicoes livres para registar o leitor do grafo.\n");
+                terminarGrafoPublicado(&estado->grafo);
+                sucesso = 0;
+            }
+            else {
+                estado->grafoDisponivel = 1;
+            }
+        }
+    }
+    else if (sucesso) {
+        printf("Mapa com %d antenas (limite do grafo: %d): CAMINHO, ALCANCAVEL e INTERSECOES ficam indisponiveis.\n",
+            mapa->totalAntenas, MAX_VERTICES);
+    }
+    libertarMapaFrequencias(mapa);
+    free(mapa);
+
+    if (!sucesso) {
+        libertarEstadoServidor(estado);
+        return 0;
+    }
+    return 1;
+}
+
+/// <summary>
+/// Liberta todas as estruturas do estado do servidor.
+/// </summary>
+/// <param name="estado">Estado a libertar.</param>
+void libertarEstadoServidor(EstadoServidor* estado) {
+    libertarIndiceEspacial(&estado->antenas);
+    libertarIndiceEspacial(&estado->nefastos);
+    if (estado->raster.nefastos != NULL) libertarRasterCompacto(&estado->raster);
+    if (estado->grafoDisponivel) {
+        retirarLeitor(&estado->grafo, estado->leitor);
+        terminarGrafoPublicado(&estado->grafo);
+        estado->grafoDisponivel = 0;
+    }
+}
+
+#pragma endregion
+
+#pragma region Protocolo
+
+/// <summary>
+/// Acrescenta texto formatado (como printf) ao fim de uma resposta, aumentando-a se necessário.
+/// </summary>
+static int acrescentarResposta(TextoResposta* resposta, const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(NULL, 0, formato, args);
+    va_end(args);
+    if (n < 0) return 0;
+
+    if (resposta->tamanho + n + 1 > resposta->capacidade) {
+        size_t capacidade = resposta->capacidade ? resposta->capacidade : 1024;
+        while (resposta->tamanho + n + 1 > capacidade) capacidade *= 2;
+        char* dados = realloc(resposta->dados, capacidade);
+        if (dados == NULL) return 0;
+        resposta->dados = dados;
+        resposta->capacidade = capacidade;
+    }
+
+    va_start(args, formato);
+    vsnprintf(resposta->dados + resposta->tamanho, n + 1, formato, args);
+    va_end(args);
+    resposta->tamanho += n;
+    return 1;
+}
+
+/// <summary>
+/// Liberta o texto de uma resposta.
+/// </summary>
+/// <param name="resposta">Resposta a libertar.</param>
+void libertarTextoResposta(TextoResposta* resposta) {
+    free(resposta->dados);
+    resposta->dados = NULL;
+    resposta->tamanho = resposta->capacidade = 0;
+}
+
+/// <summary>
+/// Procura os vértices de origem e destino de um pedido (coordenadas do mapa) na versão do grafo.
+/// </summary>
+static int procurarExtremos(const GrafoImutavel* s, const char* linha, int* origem, int* destino) {
+    int x1, y1, x2, y2;
+    if (sscanf(linha, "%*s %d %d %d %d", &x1, &y1, &x2, &y2) != 4) return 0;
+    // O grafo é carregado com linhas e colunas a começar em 0
+    *origem = procurarIndiceImutavel(s, x1 - 1, y1 - 1);
+    *destino = procurarIndiceImutavel(s, x2 - 1, y2 - 1);
+    return 1;
+}
+
+/// <summary>
+/// Responde ao pedido CAMINHO.
+/// </summary>
+static void responderCaminho(const GrafoImutavel* s, const char* linha, TextoResposta* resposta) {
+    int origem, destino, caminho[MAX_VERTICES];
+    if (!procurarExtremos(s, linha, &origem, &destino)) {
+        acrescentarResposta(resposta, "ERRO argumentos invalidos\n");
+        return;
+    }
+    if (origem == -1 || destino == -1) {
+        acrescentarResposta(resposta, "ERRO antena inexistente\n");
+        return;
+    }
+
+    int n = caminhoImutavel(s, origem, destino, caminho);
+    acrescentarResposta(resposta, "OK %d", n);
+    for (int i = 0; i < n; i++) {
+        acrescentarResposta(resposta, " %d %d", s->posicoes[caminho[i]].x + 1, s->posicoes[caminho[i]].y + 1);
+    }
+    acrescentarResposta(resposta, "\n");
+}
+
+/// <summary>
+/// Responde ao pedido ALCANCAVEL.
+/// </summary>
+static void responderAlcancavel(const GrafoImutavel* s, const char* linha, TextoResposta* resposta) {
+    int origem, destino;
+    if (!procurarExtremos(s, linha, &origem, &destino)) {
+        acrescentarResposta(resposta, "ERRO argumentos invalidos\n");
+        return;
+    }
+    if (origem == -1 || destino == -1) {
+        acrescentarResposta(resposta, "ERRO antena inexistente\n");
+        return;
+    }
+    acrescentarResposta(resposta, "OK %d\n", alcancavelImutavel(s, origem, destino));
+}
+
+/// <summary>
+/// Responde ao pedido INTERSECOES.
+/// </summary>
+static void responderIntersecoes(const GrafoImutavel* s, const char* linha, TextoResposta* resposta) {
+    char freqA, freqB;
+    float distMax;
+    if (sscanf(linha, "%*s %c %c %f", &freqA, &freqB, &distMax) != 3) {
+        acrescentarResposta(resposta, "ERRO argumentos invalidos\n");
+        return;
+    }
+
+    int total = intersecoesImutavel(s, freqA, freqB, distMax, NULL, 0);
+    int* pares = malloc((2 * (size_t)total + 1) * sizeof(int));
+    if (pares == NULL) {
+        acrescentarResposta(resposta, "ERRO memoria insuficiente\n");
+        return;
+    }
+    intersecoesImutavel(s, freqA, freqB, distMax, pares, total);
+
+    acrescentarResposta(resposta, "OK %d", total);
+    for (int i = 0; i < 2 * total; i++) {
+        acrescentarResposta(resposta, " %d %d", s->posicoes[pares[i]].x + 1, s->posicoes[pares[i]].y + 1);
+    }
+    acrescentarResposta(resposta, "\n");
+    free(pares);
+}
+
+/// <summary>
+/// Responde ao pedido JANELA, preenchendo uma linha da janela de cada vez.
+/// </summary>
+static void responderJanela(const EstadoServidor* estado, const char* linha, TextoResposta* resposta) {
+    int x0, y0, rows, cols;
+    if (sscanf(linha, "%*s %d %d %d %d", &x0, &y0, &rows, &cols) != 4
+        || rows <= 0 || cols <= 0 || rows > TAM_MAX_JANELA || cols > TAM_MAX_JANELA) {
+        acrescentarResposta(resposta, "ERRO argumentos invalidos\n");
+        return;
+    }
+
+    char* texto = malloc((size_t)cols + 1);
+    if (texto == NULL) {
+        acrescentarResposta(resposta, "ERRO memoria insuficiente\n");
+        return;
+    }
+    acrescentarResposta(resposta, "OK %d %d\n", rows, cols);
+    for (int l = 0; l < rows; l++) {
+        preencherJanela(&estado->antenas, &estado->nefastos, x0 + l, y0, 1, cols, &texto);
+        acrescentarResposta(resposta, "%s\n", texto);
+    }
+    free(texto);
+}
+
+/// <summary>
+/// Responde a um pedido (uma linha sem o fim de linha) usando a versão do grafo indicada (NULL se não houver grafo).
+/// </summary>
+/// <returns>1 para continuar, 0 para fechar a ligação, -1 para terminar o servidor.</returns>
+static int responderPedido(EstadoServidor* estado, const GrafoImutavel* s, const char* linha, TextoResposta* resposta) {
+    char comando[16];
+    if (sscanf(linha, "%15s", comando) != 1) return 1; // Linha vazia
+    estado->totalPedidos++;
+
+    int pedidoGrafo = strcmp(comando, "CAMINHO") == 0 || strcmp(comando, "ALCANCAVEL") == 0
+        || strcmp(comando, "INTERSECOES") == 0;
+    if (pedidoGrafo && s == NULL) {
+        acrescentarResposta(resposta, "ERRO mapa com mais de %d antenas, grafo indisponivel\n", MAX_VERTICES);
+    }
+    else if (strcmp(comando, "CAMINHO") == 0) {
+        responderCaminho(s, linha, resposta);
+    }
+    else if (strcmp(comando, "ALCANCAVEL") == 0) {
+        responderAlcancavel(s, linha, resposta);
+    }
+    else if (strcmp(comando, "INTERSECOES") == 0) {
+        responderIntersecoes(s, linha, resposta);
+    }
+    else if (strcmp(comando, "NEFASTO") == 0) {
+        int x, y;
+        if (sscanf(linha, "%*s %d %d", &x, &y) != 2)
+            acrescentarResposta(resposta, "ERRO argumentos invalidos\n");
+        else
+            acrescentarResposta(resposta, "OK %d\n", existeNefastoRaster(&estado->raster, x, y));
+    }
+    else if (strcmp(comando, "JANELA") == 0) {
+        responderJanela(estado, linha, resposta);
+    }
+    else if (strcmp(comando, "FIM") == 0) {
+        acrescentarResposta(resposta, "OK\n");
+        return 0;
+    }
+    else if (strcmp(comando, "DESLIGAR") == 0) {
+        acrescentarResposta(resposta, "OK\n");
+        return -1;
+    }
+    else {
+        acrescentarResposta(resposta, "ERRO pedido desconhecido\n");
+    }
+    return 1;
+}
+
+/// <summary>
+/// Responde a todas as linhas completas de um bloco de pedidos, acrescentando as respostas pela
+/// mesma ordem. O grafo publicado é obtido uma única vez para todo o lote.
+/// </summary>
+/// <param name="estado">Estado do servidor.</param>
+/// <param name="pedidos">Texto recebido (pode terminar com uma linha incompleta).</param>
+/// <param name="tamanho">Número de carateres recebidos.</param>
+/// <param name="consumidos">Número de carateres tratados (até ao fim da última linha completa).</param>
+/// <param name="resposta">Resposta onde são acrescentadas as linhas de resposta.</param>
+/// <returns>1 para continuar, 0 para fechar a ligação, -1 para terminar o servidor.</returns>
+int responderLote(EstadoServidor* estado, const char* pedidos, size_t tamanho, size_t* consumidos, TextoResposta* resposta) {
+    const GrafoImutavel* s = estado->grafoDisponivel ? entrarLeitura(&estado->grafo, estado->leitor) : NULL;
+    char linha[TAM_MAX_PEDIDO];
+    size_t pos = 0;
+    int resultado = 1;
+
+    while (resultado == 1 && pos < tamanho) {
+        const char* fim = memchr(pedidos + pos, '\n', tamanho - pos);
+        if (fim == NULL) break;
+
+        size_t n = (size_t)(fim - (pedidos + pos));
+        if (n > 0 && pedidos[pos + n - 1] == '\r') n--;
+        if (n >= sizeof(linha)) {
+            acrescentarResposta(resposta, "ERRO pedido demasiado longo\n");
+        }
+        else {
+            memcpy(linha, pedidos + pos, n);
+            linha[n] = '\0';
+            resultado = responderPedido(estado, s, linha, resposta);
+        }
+        pos = (size_t)(fim - pedidos) + 1;
+    }
+
+    if (estado->grafoDisponivel) sairLeitura(&estado->grafo, estado->leitor);
+    *consumidos = pos;
+    return resultado;
+}
+
+#pragma endregion
+
+#pragma region Servidor
+
+/// <summary>
+/// Envia todo o texto de uma resposta, mesmo que o sistema aceite apenas parte em cada envio.
+/// </summary>
+static int enviarTudo(Socket cliente, const char* dados, size_t tamanho) {
+    while (tamanho > 0) {
+        int n = send(cliente, dados, (int)(tamanho < TAM_BUFFER_PEDIDOS ? tamanho : TAM_BUFFER_PEDIDOS), OPCOES_ENVIO);
+        if (n <= 0) return 0;
+        dados += n;
+        tamanho -= (size_t)n;
+    }
+    return 1;
+}
+
+/// <summary>
+/// Atende um cliente até este fechar a ligação ou pedir FIM/DESLIGAR. Cada leitura do socket
+/// pode trazer vários pedidos, que são respondidos em lote com um único envio.
+/// </summary>
+/// <returns>-1 se o cliente pediu para terminar o servidor, 1 caso contrário.</returns>
+static int atenderCliente(EstadoServidor* estado, Socket cliente) {
+    char* pedidos = malloc(TAM_BUFFER_PEDIDOS);
+    TextoResposta resposta = { NULL, 0, 0 };
+    size_t tamanho = 0;
+    int resultado = 1;
+    if (pedidos == NULL) return 1;
+
+    while (resultado == 1) {
+        int n = recv(cliente, pedidos + tamanho, (int)(TAM_BUFFER_PEDIDOS - tamanho), 0);
+        if (n <= 0) break;
+        tamanho += (size_t)n;
+
+        size_t consumidos;
+        resultado = responderLote(estado, pedidos, tamanho, &consumidos, &resposta);
+        if (consumidos == 0 && tamanho == TAM_BUFFER_PEDIDOS) {
+            // Buffer cheio sem nenhuma linha completa: descarta o pedido
+            acrescentarResposta(&resposta, "ERRO pedido demasiado longo\n");
+            consumidos = tamanho;
+        }
+        memmove(pedidos, pedidos + consumidos, tamanho - consumidos);
+        tamanho -= consumidos;
+
+        if (resposta.tamanho > 0 && !enviarTudo(cliente, resposta.dados, resposta.tamanho)) break;
+        resposta.tamanho = 0;
+    }
+
+    libertarTextoResposta(&resposta);
+    free(pedidos);
+    return resultado == -1 ? -1 : 1;
+}
+
+/// <summary>
+/// Prepara o caminho onde o socket vai ser criado. Um socket deixado por uma execução anterior é apagado;
+/// se o caminho existir e não for um socket (por exemplo, um ficheiro indicado por engano), nada é apagado.
+/// </summary>
+/// <param name="caminhoSocket">Caminho do socket local.</param>
+/// <returns>1 se o caminho ficou livre, 0 em caso de erro.</returns>
+static int libertarCaminhoSocket(const char* caminhoSocket) {
+#ifdef _WIN32
+    // No Windows, os sockets locais são pontos de reanálise (reparse points) no sistema de ficheiros
+    DWORD atributos = GetFileAttributesA(caminhoSocket);
+    if (atributos == INVALID_FILE_ATTRIBUTES) return 1;
+    int eSocket = (atributos & FILE_ATTRIBUTE_REPARSE_POINT) && !(atributos & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat info;
+    if (lstat(caminhoSocket, &info) != 0) return 1;
+    int eSocket = S_ISSOCK(info.st_mode);
+#endif
+    if (!eSocket) {
+        printf("O caminho %s ja existe e nao e um socket.\n", caminhoSocket);
+        return 0;
+    }
+    if (remove(caminhoSocket) != 0) {
+        perror("Erro ao apagar o socket anterior");
+        return 0;
+    }
+    return 1;
+}
+
+/// <summary>
+/// Executa o servidor de consultas: carrega o mapa, cria o socket local e atende os clientes,
+/// um de cada vez, até receber o pedido DESLIGAR.
+/// </summary>
+/// <param name="ficheiro">Nome do ficheiro de mapa.</param>
+/// <param name="caminhoSocket">Caminho do socket local a criar.</param>
+/// <returns>1 se o servidor terminou normalmente, 0 em caso de erro.</returns>
+int executarServidor(const char* ficheiro, const char* caminhoSocket) {
+    struct sockaddr_un endereco;
+    if (strlen(caminhoSocket) >= sizeof(endereco.sun_path)) {
+        printf("Caminho do socket demasiado longo: %s\n", caminhoSocket);
+        return 0;
+    }
+    if (!libertarCaminhoSocket(caminhoSocket)) return 0;
+
+    EstadoServidor* estado = malloc(sizeof(EstadoServidor));
+    if (estado == NULL) {
+        perror("Erro na alocação do estado do servidor");
+        return 0;
+    }
+    if (!carregarEstadoServidor(estado, ficheiro)) {
+        printf("Erro ao carregar o mapa %s.\n", ficheiro);
+        free(estado);
+        return 0;
+    }
+
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+
+    Socket servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminhoSocket);
+
+    if (servidor == SOCKET_INVALIDO
+        || bind(servidor, (struct sockaddr*)&endereco, sizeof(endereco)) != 0
+        || listen(servidor, 16) != 0) {
+        perror("Erro ao criar o socket do servidor");
+        if (servidor != SOCKET_INVALIDO) fecharSocket(servidor);
+        libertarEstadoServidor(estado);
+        free(estado);
+        return 0;
+    }
+
+    printf("Servidor a aguardar pedidos em %s\n", caminhoSocket);
+    fflush(stdout);
+    for (;;) {
+        Socket cliente = accept(servidor, NULL, NULL);
+        if (cliente == SOCKET_INVALIDO) {
+            perror("Erro ao aceitar ligação");
+            break;
+        }
+        int resultado = atenderCliente(estado, cliente);
+        fecharSocket(cliente);
+        if (resultado == -1) break;
+    }
+
+    printf("Servidor terminado apos %lld pedidos.\n", estado->totalPedidos);
+    fecharSocket(servidor);
+    remove(caminhoSocket);
+    libertarEstadoServidor(estado);
+    free(estado);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 1;
+}
+
+#pragma endregion
@@ -0,0 +1,27 @@
+/*
+ *  @file funcoes_servidor.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-07
+ *  @project EDA
+ *
+ *  Declarao das funes do servidor de consultas: o mapa  carregado uma vez e os pedidos
+ *  chegam por um socket local (Unix), uma linha de texto por pedido.
+ */
+
+#ifndef FUNCOES_SERVIDOR_H
+#define FUNCOES_SERVIDOR_H
+
+#include "dados.h"
+
+// Estado mantido entre pedidos
+int carregarEstadoServidor(EstadoServidor* estado, const char* ficheiro);
+void libertarEstadoServidor(EstadoServidor* estado);
+
+// Protocolo
+int responderLote(EstadoServidor* estado, const char* pedidos, size_t tamanho, size_t* consumidos, TextoResposta* resposta);
+void libertarTextoResposta(TextoResposta* resposta);
+
+// Servidor
+int executarServidor(const char* ficheiro, const char* caminhoSocket);
+
+#endif // FUNCOES_SERVIDOR_H
@@ -0,0 +1,540 @@
+﻿/*
+ *  @file funcoes_versoes.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-23
+ *  @project EDA
+ *
+ *  Implementação das versões de conjuntos de antenas. As antenas de cada versão estão numa treap
+ *  persistente: alterar uma versão copia apenas o caminho até à antena alterada e partilha o resto
+ *  da árvore com as outras versões, pelo que criar um cenário a partir de outro é O(1).
+ *  Os nefastos e as componentes só são calculados quando pedidos e ficam guardados na versão.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "funcoes.h"
+#include "funcoes_grafos.h"
+#include "funcoes_raster.h"
+#include "funcoes_versoes.h"
+
+#pragma region Árvore Persistente
+
+/// <summary>
+/// Compara duas posições pela ordem linha/coluna.
+/// </summary>
+static int compararChave(int x1, int y1, int x2, int y2) {
+    if (x1 != x2) return x1 < x2 ? -1 : 1;
+    if (y1 != y2) return y1 < y2 ? -1 : 1;
+    return 0;
+}
+
+/// <summary>
+/// Calcula a prioridade de uma antena a partir das coordenadas. Como não depende da ordem das
+/// operações, versões com as mesmas antenas têm sempre a mesma forma de árvore.
+/// </summary>
+static unsigned int prioridadeCoordenadas(int x, int y) {
+    unsigned int h = (unsigned int)x * 0x9E3779B1u ^ (unsigned int)y * 0x85EBCA77u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+/// <summary>
+/// Indica se o nó a deve ficar acima do nó b (maior prioridade; em caso de empate, menor posição).
+/// </summary>
+static int acimaDe(const NoVersao* a, const NoVersao* b) {
+    if (a->prioridade != b->prioridade) return a->prioridade > b->prioridade;
+    return compararChave(a->x, a->y, b->x, b->y) < 0;
+}
+
+/// <summary>
+/// Acrescenta uma referência a um nó (se existir) e devolve-o.
+/// </summary>
+static NoVersao* reterNo(NoVersao* no) {
+    if (no != NULL) no->referencias++;
+    return no;
+}
+
+/// <summary>
+/// Retira uma referência a um nó; se era a última, liberta o nó e larga as referências aos filhos.
+/// </summary>
+static void largarNo(NoVersao* no) {
+    while (no != NULL && --no->referencias == 0) {
+        NoVersao* dir = no->dir;
+        largarNo(no->esq);
+        free(no);
+        no = dir;
+    }
+}
+
+/// <summary>
+/// Cria uma cópia de um nó com novos filhos, ficando com as referências recebidas para os filhos.
+/// Em caso de erro de alocação, larga os filhos e assinala o erro.
+/// </summary>
+static NoVersao* copiarNo(const NoVersao* origem, NoVersao* esq, NoVersao* dir, int* erro) {
+    NoVersao* novo = malloc(sizeof(NoVersao));
+    if (novo == NULL) {
+        largarNo(esq);
+        largarNo(dir);
+        *erro = 1;
+        return NULL;
+    }
+    *novo = *origem;
+    novo->referencias = 1;
+    novo->esq = esq;
+    novo->dir = dir;
+    return novo;
+}
+
+/// <summary>
+/// Divide uma árvore nas antenas anteriores e posteriores a (x, y), sem alterar a original.
+/// Apenas os nós do caminho até (x, y) são copiados; as restantes subárvores são partilhadas.
+/// </summary>
+static void dividirArvore(NoVersao* t, int x, int y, NoVersao** menores, NoVersao** maiores, int* erro) {
+    NoVersao* a;
+    NoVersao* b;
+    if (t == NULL) {
+        *menores = *maiores = NULL;
+        return;
+    }
+    if (compararChave(t->x, t->y, x, y) < 0) {
+        dividirArvore(t->dir, x, y, &a, &b, erro);
+        *menores = copiarNo(t, reterNo(t->esq), a, erro);
+        *maiores = b;
+    }
+    else {
+        dividirArvore(t->esq, x, y, &a, &b, erro);
+        *menores = a;
+        *maiores = copiarNo(t, b, reterNo(t->dir), erro);
+    }
+}
+
+/// <summary>
+/// Junta duas árvores (todas as antenas de a anteriores às de b) numa nova árvore.
+/// </summary>
+static NoVersao* juntarArvores(NoVersao* a, NoVersao* b, int* erro) {
+    if (a == NULL) return reterNo(b);
+    if (b == NULL) return reterNo(a);
+    if (acimaDe(a, b))
+        return copiarNo(a, reterNo(a->esq), juntarArvores(a->dir, b, erro), erro);
+    return copiarNo(b, juntarArvores(a, b->esq, erro), reterNo(b->dir), erro);
+}
+
+/// <summary>
+/// Devolve uma nova árvore com o nó indicado (ainda não partilhado) inserido.
+/// A posição do novo nó não pode existir na árvore.
+/// </summary>
+static NoVersao* inserirNo(NoVersao* t, NoVersao* novo, int* erro) {
+    if (t == NULL) return novo;
+    if (acimaDe(novo, t)) {
+        dividirArvore(t, novo->x, novo->y, &novo->esq, &novo->dir, erro);
+        return novo;
+    }
+    if (compararChave(novo->x, novo->y, t->x, t->y) < 0)
+        return copiarNo(t, inserirNo(t->esq, novo, erro), reterNo(t->dir), erro);
+    return copiarNo(t, reterNo(t->esq), inserirNo(t->dir, novo, erro), erro);
+}
+
+/// <summary>
+/// Devolve uma nova árvore sem a antena em (x, y), que tem de existir na árvore.
+/// </summary>
+static NoVersao* retirarNo(NoVersao* t, int x, int y, int* erro) {
+    int c = compararChave(x, y, t->x, t->y);
+    if (c == 0) return juntarArvores(t->esq, t->dir, erro);
+    if (c < 0) return copiarNo(t, retirarNo(t->esq, x, y, erro), reterNo(t->dir), erro);
+    return copiarNo(t, reterNo(t->esq), retirarNo(t->dir, x, y, erro), erro);
+}
+
+/// <summary>
+/// Procura a antena em (x, y) numa árvore.
+/// </summary>
+static const NoVersao* procurarNo(const NoVersao* t, int x, int y) {
+    while (t != NULL) {
+        int c = compararChave(x, y, t->x, t->y);
+        if (c == 0) return t;
+        t = c < 0 ? t->esq : t->dir;
+    }
+    return NULL;
+}
+
+#pragma endregion
+
+#pragma region Criação e Alteração de Versões
+
+/// <summary>
+/// Larga uma referência aos nefastos de uma versão, libertando-os se já ninguém os usar.
+/// </summary>
+static void largarNefastos(NefastosVersao* nefastos) {
+    if (nefastos != NULL && --nefastos->referencias == 0) {
+        libertarIndiceEspacial(&nefastos->indice);
+        free(nefastos);
+    }
+}
+
+/// <summary>
+/// Descarta os resultados derivados de uma versão, depois de as suas antenas mudarem.
+/// </summary>
+static void invalidarResultados(VersaoAntenas* versao) {
+    largarNefastos(versao->nefastos);
+    versao->nefastos = NULL;
+    versao->componentesCalculados = 0;
+}
+
+/// <summary>
+/// Cria a versão base a partir de uma lista de antenas. Se houver antenas repetidas na mesma
+/// posição, fica apenas a primeira.
+/// </summary>
+/// <param name="lista">Lista de antenas.</param>
+/// <returns>Nova versão ou NULL em caso de erro.</returns>
+VersaoAntenas* criarVersaoAntenas(const Antena* lista) {
+    VersaoAntenas* versao = calloc(1, sizeof(VersaoAntenas));
+    if (versao == NULL) {
+        perror("Erro na alocação da versão");
+        return NULL;
+    }
+    for (; lista != NULL; lista = lista->next) {
+        adicionarAntenaVersao(versao, lista->freq, lista->x, lista->y);
+    }
+    return versao;
+}
+
+/// <summary>
+/// Cria um novo cenário a partir de uma versão existente, em O(1): a árvore de antenas e os
+/// resultados já calculados passam a ser partilhados pelas duas versões.
+/// </summary>
+/// <param name="base">Versão de origem.</param>
+/// <returns>Nova versão ou NULL em caso de erro.</returns>
+VersaoAntenas* bifurcarVersao(const VersaoAntenas* base) {
+    VersaoAntenas* versao = malloc(sizeof(VersaoAntenas));
+    if (versao == NULL) {
+        perror("Erro na alocação da versão");
+        return NULL;
+    }
+    *versao = *base;
+    reterNo(versao->raiz);
+    if (versao->nefastos != NULL) versao->nefastos->referencias++;
+    return versao;
+}
+
+/// <summary>
+/// Liberta uma versão. Os nós e resultados partilhados com outras versões só são libertados
+/// quando a última versão que os usa for libertada.
+/// </summary>
+/// <param name="versao">Versão a libertar.</param>
+void libertarVersao(VersaoAntenas* versao) {
+    if (versao == NULL) return;
+    largarNo(versao->raiz);
+    largarNefastos(versao->nefastos);
+    free(versao);
+}
+
+/// <summary>
+/// Adiciona uma antena a uma versão, sem alterar as outras versões que partilham a mesma árvore.
+/// </summary>
+/// <param name="versao">Versão a alterar.</param>
+/// <param name="freq">Frequência da antena.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>1 se a antena foi adicionada; 0 se a posição estiver ocupada ou em caso de erro.</returns>
+int adicionarAntenaVersao(VersaoAntenas* versao, char freq, int x, int y) {
+    if (procurarNo(versao->raiz, x, y) != NULL) return 0;
+
+    NoVersao* novo = malloc(sizeof(NoVersao));
+    if (novo == NULL) {
+        printf("Erro ao adicionar a antena (%d, %d).\n", x, y);
+        return 0;
+    }
+    novo->freq = freq;
+    novo->x = x;
+    novo->y = y;
+    novo->prioridade = prioridadeCoordenadas(x, y);
+    novo->referencias = 1;
+    novo->esq = novo->dir = NULL;
+
+    int erro = 0;
+    NoVersao* raiz = inserirNo(versao->raiz, novo, &erro);
+    if (erro) {
+        largarNo(raiz);
+        printf("Erro ao adicionar a antena (%d, %d).\n", x, y);
+        return 0;
+    }
+
+    largarNo(versao->raiz);
+    versao->raiz = raiz;
+    versao->totalAntenas++;
+    invalidarResultados(versao);
+    return 1;
+}
+
+/// <summary>
+/// Remove a antena em (x, y) de uma versão, sem alterar as outras versões.
+/// </summary>
+/// <param name="versao">Versão a alterar.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>1 se a antena foi removida; 0 se não existir ou em caso de erro.</returns>
+int removerAntenaVersao(VersaoAntenas* versao, int x, int y) {
+    if (procurarNo(versao->raiz, x, y) == NULL) return 0;
+
+    int erro = 0;
+    NoVersao* raiz = retirarNo(versao->raiz, x, y, &erro);
+    if (erro) {
+        largarNo(raiz);
+        printf("Erro ao remover a antena (%d, %d).\n", x, y);
+        return 0;
+    }
+
+    largarNo(versao->raiz);
+    versao->raiz = raiz;
+    versao->totalAntenas--;
+    invalidarResultados(versao);
+    return 1;
+}
+
+#pragma endregion
+
+#pragma region Resultados Derivados
+
+/// <summary>
+/// Preenche um mapa de frequências com as antenas de uma árvore, percorrida por ordem
+/// linha/coluna, ficando cada grupo ordenado como espera o resto do projeto.
+/// </summary>
+static int preencherMapaVersao(const NoVersao* t, MapaFrequencias* mapa) {
+    if (t == NULL) return 1;
+    if (!preencherMapaVersao(t->esq, mapa)) return 0;
+    if (!adicionarCoordenadaGrupo(&mapa->grupos[(unsigned char)t->freq], t->x, t->y)) return 0;
+    mapa->totalAntenas++;
+    return preencherMapaVersao(t->dir, mapa);
+}
+
+/// <summary>
+/// Calcula os nefastos de uma versão, caso ainda não estejam calculados.
+/// </summary>
+static int calcularNefastosVersao(VersaoAntenas* versao) {
+    if (versao->nefastos != NULL) return 1;
+
+    MapaFrequencias* mapa = malloc(sizeof(MapaFrequencias));
+    NefastosVersao* nefastos = malloc(sizeof(NefastosVersao));
+    if (mapa == NULL || nefastos == NULL) {
+        perror("Erro na alocação dos nefastos da versão");
+        free(mapa);
+        free(nefastos);
+        return 0;
+    }
+    inicializarMapaFrequencias(mapa);
+
+    int sucesso = preencherMapaVersao(versao->raiz, mapa) && criarIndiceNefastos(mapa, &nefastos->indice);
+    libertarMapaFrequencias(mapa);
+    free(mapa);
+    if (!sucesso) {
+        free(nefastos);
+        return 0;
+    }
+
+    nefastos->referencias = 1;
+    versao->nefastos = nefastos;
+    return 1;
+}
+
+/// <summary>
+/// Devolve o número de posições nefastas de uma versão (calculado apenas na primeira consulta
+/// após cada alteração).
+/// </summary>
+/// <param name="versao">Versão a consultar.</param>
+/// <returns>Número de nefastos, ou -1 em caso de erro.</returns>
+int contarNefastosVersao(VersaoAntenas* versao) {
+    if (!calcularNefastosVersao(versao)) return -1;
+    return versao->nefastos->indice.total;
+}
+
+/// <summary>
+/// Verifica se a posição (x, y) é nefasta numa versão.
+/// </summary>
+/// <param name="versao">Versão a consultar.</param>
+/// <param name="x">Coordenada X.</param>
+/// <param name="y">Coordenada Y.</param>
+/// <returns>1 se for nefasta, 0 caso contrário (ou em caso de erro).</returns>
+int existeNefastoVersao(VersaoAntenas* versao, int x, int y) {
+    if (!calcularNefastosVersao(versao)) return 0;
+    const IndiceEspacial* indice = &versao->nefastos->indice;
+    int pos = procurarPontoIndice(indice, x, y);
+    return pos < indice->total && indice->pontos[pos].x == x && indice->pontos[pos].y == y;
+}
+
+/// <summary>
+/// Insere no grafo as antenas de uma árvore, por ordem linha/coluna.
+/// </summary>
+static void inserirVerticesVersao(const NoVersao* t, Grafo* g) {
+    if (t == NULL) return;
+    inserirVerticesVersao(t->esq, g);
+    inserirVertice(g, t->freq, t->x, t->y);
+    inserirVerticesVersao(t->dir, g);
+}
+
+/// <summary>
+/// Devolve o número de componentes do grafo de uma versão (calculado apenas na primeira consulta
+/// após cada alteração).
+/// </summary>
+/// <param name="versao">Versão a consultar.</param>
+/// <returns>Número de componentes, ou -1 se houver mais de MAX_VERTICES antenas ou em caso de erro.</returns>
+int contarComponentesVersao(VersaoAntenas* versao) {
+    if (versao->componentesCalculados) return versao->totalComponentes;
+
+    if (versao->totalAntenas > MAX_VERTICES) {
+        versao->totalComponentes = -1;
+    }
+    else {
+        Grafo* g = malloc(sizeof(Grafo));
+        if (g == NULL) return -1;
+        inicializarGrafo(g);
+        inserirVerticesVersao(versao->raiz, g);
+        criarArestasPorFrequencia(g);
+        versao->totalComponentes = contarComponentesGrafo(g, NULL);
+        libertarGrafo(g);
+        free(g);
+    }
+    versao->componentesCalculados = 1;
+    return versao->totalComponentes;
+}
+
+#pragma endregion
+
+#pragma region Listagens
+
+/// <summary>
+/// Imprime as antenas de uma árvore por ordem linha/coluna.
+/// </summary>
+static void listarNos(const NoVersao* t) {
+    if (t == NULL) return;
+    listarNos(t->esq);
+    printf("    %c     | %d | %d\n", t->freq, t->x, t->y);
+    listarNos(t->dir);
+}
+
+/// <summary>
+/// Imprime todas as antenas de uma versão no ecrã de forma tabular.
+/// </summary>
+/// <param name="versao">Versão a listar.</param>
+void listarAntenasVersao(const VersaoAntenas* versao) {
+    if (versao->raiz == NULL) {
+        printf("\nLista de antenas vazia.\n");
+        return;
+    }
+    printf("\nLista de Antenas (%d)\n", versao->totalAntenas);
+    printf("Frequencia | X | Y\n");
+    printf("------------------\n");
+    listarNos(versao->raiz);
+}
+
+/// <summary>
+/// Elemento da pilha de um percurso em ordem: uma subárvore ainda por expandir ou um nó por visitar.
+/// </summary>
+typedef struct {
+    const NoVersao* no;
+    int subarvore;
+} ItemPercurso;
+
+/// <summary>
+/// Pilha de um percurso em ordem de uma árvore de versão.
+/// </summary>
+typedef struct {
+    ItemPercurso* itens;
+    int total, capacidade;
+} Percurso;
+
+/// <summary>
+/// Coloca um elemento no topo da pilha do percurso (as subárvores vazias são ignoradas).
+/// </summary>
+static int empilharPercurso(Percurso* p, const NoVersao* no, int subarvore) {
+    if (no == NULL) return 1;
+    if (p->total == p->capacidade) {
+        int capacidade = p->capacidade ? p->capacidade * 2 : 32;
+        ItemPercurso* itens = realloc(p->itens, capacidade * sizeof(ItemPercurso));
+        if (itens == NULL) return 0;
+        p->itens = itens;
+        p->capacidade = capacidade;
+    }
+    p->itens[p->total].no = no;
+    p->itens[p->total].subarvore = subarvore;
+    p->total++;
+    return 1;
+}
+
+/// <summary>
+/// Substitui a subárvore do topo da pilha pela subárvore direita, pelo nó e pela subárvore esquerda.
+/// </summary>
+static int expandirPercurso(Percurso* p) {
+    const NoVersao* t = p->itens[--p->total].no;
+    return empilharPercurso(p, t->dir, 1) && empilharPercurso(p, t, 0) && empilharPercurso(p, t->esq, 1);
+}
+
+/// <summary>
+/// Lista as antenas acrescentadas (+), removidas (-) e com frequência alterada (~) de um cenário
+/// em relação a outra versão. As duas árvores são percorridas em ordem ao mesmo tempo e as
+/// subárvores partilhadas são saltadas sem serem visitadas, pelo que o custo depende apenas
+/// do número de alterações e não do número de antenas.
+/// </summary>
+/// <param name="base">Versão de referência.</param>
+/// <param name="cenario">Versão a comparar.</param>
+/// <returns>Número de diferenças, ou -1 em caso de erro.</returns>
+int listarDiferencasVersoes(const VersaoAntenas* base, const VersaoAntenas* cenario) {
+    Percurso a = { NULL, 0, 0 };
+    Percurso b = { NULL, 0, 0 };
+    int diferencas = 0;
+    int sucesso = empilharPercurso(&a, base->raiz, 1) && empilharPercurso(&b, cenario->raiz, 1);
+
+    printf("\nDiferencas entre versoes\n");
+    printf("  | Frequencia | X | Y\n");
+    printf("---------------------\n");
+    while (sucesso && (a.total > 0 || b.total > 0)) {
+        const ItemPercurso* ta = a.total > 0 ? &a.itens[a.total - 1] : NULL;
+        const ItemPercurso* tb = b.total > 0 ? &b.itens[b.total - 1] : NULL;
+
+        // Subárvore partilhada pelas duas versões: tem as mesmas antenas
+        if (ta && tb && ta->subarvore && tb->subarvore && ta->no == tb->no) {
+            a.total--;
+            b.total--;
+            continue;
+        }
+        // Expande primeiro a subárvore cuja raiz fica mais acima, onde não pode estar a partilhada
+        if (ta && ta->subarvore && (!tb || !tb->subarvore || !acimaDe(tb->no, ta->no))) {
+            sucesso = expandirPercurso(&a);
+            continue;
+        }
+        if (tb && tb->subarvore) {
+            sucesso = expandirPercurso(&b);
+            continue;
+        }
+
+        int c = ta == NULL ? 1 : tb == NULL ? -1 : compararChave(ta->no->x, ta->no->y, tb->no->x, tb->no->y);
+        if (c < 0) {
+            printf("- |     %c      | %d | %d\n", ta->no->freq, ta->no->x, ta->no->y);
+            diferencas++;
+            a.total--;
+        }
+        else if (c > 0) {
+            printf("+ |     %c      | %d | %d\n", tb->no->freq, tb->no->x, tb->no->y);
+            diferencas++;
+            b.total--;
+        }
+        else {
+            if (ta->no->freq != tb->no->freq) {
+                printf("~ |   %c -> %c   | %d | %d\n", ta->no->freq, tb->no->freq, tb->no->x, tb->no->y);
+                diferencas++;
+            }
+            a.total--;
+            b.total--;
+        }
+    }
+
+    free(a.itens);
+    free(b.itens);
+    if (!sucesso) {
+        printf("Erro ao comparar as versoes.\n");
+        return -1;
+    }
+    return diferencas;
+}
+
+#pragma endregion
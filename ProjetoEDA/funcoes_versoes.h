@@ -0,0 +1,34 @@
+/*
+ *  @file funcoes_versoes.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-06-23
+ *  @project EDA
+ *
+ *  Declarao das funes de verses (cenrios) de conjuntos de antenas com partilha
+ *  de estrutura e clculo diferido dos resultados derivados.
+ */
+
+#ifndef FUNCOES_VERSOES_H
+#define FUNCOES_VERSOES_H
+
+#include "dados.h"
+
+// Criao e libertao
+VersaoAntenas* criarVersaoAntenas(const Antena* lista);
+VersaoAntenas* bifurcarVersao(const VersaoAntenas* base);
+void libertarVersao(VersaoAntenas* versao);
+
+// Alteraes
+int adicionarAntenaVersao(VersaoAntenas* versao, char freq, int x, int y);
+int removerAntenaVersao(VersaoAntenas* versao, int x, int y);
+
+// Resultados derivados (calculados apenas quando pedidos)
+int contarNefastosVersao(VersaoAntenas* versao);
+int existeNefastoVersao(VersaoAntenas* versao, int x, int y);
+int contarComponentesVersao(VersaoAntenas* versao);
+
+// Listagens
+void listarAntenasVersao(const VersaoAntenas* versao);
+int listarDiferencasVersoes(const VersaoAntenas* base, const VersaoAntenas* cenario);
+
+#endif // FUNCOES_VERSOES_H
@@ -0,0 +1,353 @@
+﻿/*
+ *  @file funcoes_vizinhos.c
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-28
+ *  @project EDA
+ *
+ *  Implementação da procura das k antenas mais próximas de um ponto. As antenas de cada frequência
+ *  são organizadas numa árvore k-d implícita (sem ponteiros) e a procura é feita pela ordem da menor
+ *  distância possível de cada subárvore (best-first), parando quando nenhuma subárvore por visitar
+ *  pode ter antenas mais próximas do que as k já encontradas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include "funcoes_grafos.h"
+#include "funcoes_vizinhos.h"
+
+/// <summary>
+/// Ponto usado durante a construção da árvore (coordenadas e índice do vértice).
+/// </summary>
+typedef struct {
+    Coordenada p;
+    int vertice;
+} PontoArvore;
+
+/// <summary>
+/// Subárvore por visitar: intervalo de pontos, eixo da raiz, retângulo que contém os pontos
+/// e quadrado da menor distância possível entre o ponto procurado e esse retângulo.
+/// </summary>
+typedef struct {
+    int inicio, fim, eixo;
+    int minX, maxX, minY, maxY;
+    long long limite;
+} SubarvorePendente;
+
+#pragma region Construção
+
+/// <summary>
+/// Compara dois pontos pela coordenada X (e depois Y e vértice, para a árvore não depender da ordem inicial).
+/// </summary>
+static int compararPorX(const void* a, const void* b) {
+    const PontoArvore* p = (const PontoArvore*)a;
+    const PontoArvore* q = (const PontoArvore*)b;
+    if (p->p.x != q->p.x) return p->p.x < q->p.x ? -1 : 1;
+    if (p->p.y != q->p.y) return p->p.y < q->p.y ? -1 : 1;
+    return (p->vertice > q->vertice) - (p->vertice < q->vertice);
+}
+
+/// <summary>
+/// Compara dois pontos pela coordenada Y (e depois X e vértice).
+/// </summary>
+static int compararPorY(const void* a, const void* b) {
+    const PontoArvore* p = (const PontoArvore*)a;
+    const PontoArvore* q = (const PontoArvore*)b;
+    if (p->p.y != q->p.y) return p->p.y < q->p.y ? -1 : 1;
+    if (p->p.x != q->p.x) return p->p.x < q->p.x ? -1 : 1;
+    return (p->vertice > q->vertice) - (p->vertice < q->vertice);
+}
+
+/// <summary>
+/// Organiza os pontos [inicio, fim) como árvore k-d implícita: ordena-os pelo eixo do nível,
+/// fica com a mediana no meio e repete para as duas metades com o outro eixo.
+/// </summary>
+static void construirArvore(PontoArvore* pontos, int inicio, int fim, int eixo) {
+    if (fim - inicio <= 1) return;
+    qsort(pontos + inicio, fim - inicio, sizeof(PontoArvore), eixo == 0 ? compararPorX : compararPorY);
+    int meio = inicio + (fim - inicio) / 2;
+    construirArvore(pontos, inicio, meio, 1 - eixo);
+    construirArvore(pontos, meio + 1, fim, 1 - eixo);
+}
+
+/// <summary>
+/// Cria as árvores k-d de todas as frequências a partir dos vértices do grafo.
+/// As árvores não acompanham alterações posteriores do grafo: devem ser criadas de novo.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo.</param>
+/// <param name="a">Estrutura onde são guardadas as árvores.</param>
+/// <returns>True em caso de sucesso; false em caso de erro de alocação.</returns>
+bool criarArvoreVizinhos(Grafo* g, ArvoreVizinhos* a) {
+    int n = g->tamanho;
+    PontoArvore* temp = malloc((n + 1) * sizeof(PontoArvore));
+    a->pontos = malloc((n + 1) * sizeof(Coordenada));
+    a->vertices = malloc((n + 1) * sizeof(int));
+    if (!temp || !a->pontos || !a->vertices) {
+        perror("Erro na alocação da árvore de vizinhos");
+        free(temp);
+        libertarArvoreVizinhos(a);
+        return false;
+    }
+
+    // Agrupa os vértices por frequência, usando as listas de frequência do grafo
+    int k = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        a->inicioFrequencia[f] = k;
+        for (int v = g->inicioFreq[f]; v != -1; v = g->vertices[v].seguinteFreq) {
+            temp[k].p.x = g->vertices[v].x;
+            temp[k].p.y = g->vertices[v].y;
+            temp[k].vertice = v;
+            k++;
+        }
+        construirArvore(temp, a->inicioFrequencia[f], k, 0);
+    }
+    a->inicioFrequencia[NUM_FREQUENCIAS] = k;
+
+    for (int i = 0; i < k; i++) {
+        a->pontos[i] = temp[i].p;
+        a->vertices[i] = temp[i].vertice;
+    }
+    free(temp);
+    return true;
+}
+
+/// <summary>
+/// Liberta a memória ocupada pelas árvores de vizinhos.
+/// </summary>
+/// <param name="a">Árvores a libertar.</param>
+void libertarArvoreVizinhos(ArvoreVizinhos* a) {
+    free(a->pontos);
+    free(a->vertices);
+    a->pontos = NULL;
+    a->vertices = NULL;
+}
+
+#pragma endregion
+
+#pragma region Procura
+
+/// <summary>
+/// Indica se o vizinho a é pior (mais distante) do que b; em caso de empate, o de maior índice é pior.
+/// </summary>
+static int piorVizinho(const Vizinho* a, const Vizinho* b) {
+    if (a->distancia2 != b->distancia2) return a->distancia2 > b->distancia2;
+    return a->vertice > b->vertice;
+}
+
+/// <summary>
+/// Repõe a heap máxima de vizinhos (o pior no topo) a partir da posição indicada.
+/// </summary>
+static void descerVizinhos(Vizinho* heap, int tamanho, int pos) {
+    for (;;) {
+        int maior = pos;
+        int esq = 2 * pos + 1, dir = 2 * pos + 2;
+        if (esq < tamanho && piorVizinho(&heap[esq], &heap[maior])) maior = esq;
+        if (dir < tamanho && piorVizinho(&heap[dir], &heap[maior])) maior = dir;
+        if (maior == pos) return;
+
+        Vizinho temp = heap[pos];
+        heap[pos] = heap[maior];
+        heap[maior] = temp;
+        pos = maior;
+    }
+}
+
+/// <summary>
+/// Coloca uma subárvore na heap mínima de subárvores por visitar (ordenada pelo limite).
+/// </summary>
+static void colocarPendente(SubarvorePendente* heap, int* tamanho, const SubarvorePendente* item) {
+    int pos = (*tamanho)++;
+    heap[pos] = *item;
+    while (pos > 0 && heap[(pos - 1) / 2].limite > heap[pos].limite) {
+        SubarvorePendente temp = heap[pos];
+        heap[pos] = heap[(pos - 1) / 2];
+        heap[(pos - 1) / 2] = temp;
+        pos = (pos - 1) / 2;
+    }
+}
+
+/// <summary>
+/// Retira da heap mínima a subárvore com menor limite.
+/// </summary>
+static SubarvorePendente retirarPendente(SubarvorePendente* heap, int* tamanho) {
+    SubarvorePendente topo = heap[0];
+    heap[0] = heap[--(*tamanho)];
+    int pos = 0;
+    for (;;) {
+        int menor = pos;
+        int esq = 2 * pos + 1, dir = 2 * pos + 2;
+        if (esq < *tamanho && heap[esq].limite < heap[menor].limite) menor = esq;
+        if (dir < *tamanho && heap[dir].limite < heap[menor].limite) menor = dir;
+        if (menor == pos) break;
+
+        SubarvorePendente temp = heap[pos];
+        heap[pos] = heap[menor];
+        heap[menor] = temp;
+        pos = menor;
+    }
+    return topo;
+}
+
+/// <summary>
+/// Calcula o quadrado da menor distância entre (x, y) e o retângulo de uma subárvore.
+/// </summary>
+static long long distanciaRetangulo(const SubarvorePendente* s, int x, int y) {
+    long long dx = x < s->minX ? (long long)s->minX - x : x > s->maxX ? (long long)x - s->maxX : 0;
+    long long dy = y < s->minY ? (long long)s->minY - y : y > s->maxY ? (long long)y - s->maxY : 0;
+    return dx * dx + dy * dy;
+}
+
+/// <summary>
+/// Procura best-first numa árvore de uma frequência, usando o vetor de subárvores pendentes indicado
+/// (com pelo menos tantas posições como pontos da frequência).
+/// </summary>
+static int procurarNaArvore(const ArvoreVizinhos* a, int f, int x, int y, int k, int excluir,
+    Vizinho* resultado, SubarvorePendente* pendentes) {
+    int total = 0, numPendentes = 0;
+    if (k <= 0 || a->inicioFrequencia[f] == a->inicioFrequencia[f + 1]) return 0;
+
+    SubarvorePendente raiz = { a->inicioFrequencia[f], a->inicioFrequencia[f + 1], 0, INT_MIN, INT_MAX, INT_MIN, INT_MAX, 0 };
+    colocarPendente(pendentes, &numPendentes, &raiz);
+
+    while (numPendentes > 0) {
+        SubarvorePendente s = retirarPendente(pendentes, &numPendentes);
+        // Nenhuma subárvore por visitar pode ter antenas mais próximas do que a pior das k encontradas
+        if (total == k && s.limite > resultado[0].distancia2) break;
+
+        int meio = s.inicio + (s.fim - s.inicio) / 2;
+        const Coordenada* p = &a->pontos[meio];
+        if (a->vertices[meio] != excluir) {
+            Vizinho candidato;
+            candidato.vertice = a->vertices[meio];
+            candidato.distancia2 = (long long)(p->x - x) * (p->x - x) + (long long)(p->y - y) * (p->y - y);
+            if (total < k) {
+                // Insere no fim e sobe enquanto for pior do que o pai
+                int pos = total++;
+                resultado[pos] = candidato;
+                while (pos > 0 && piorVizinho(&resultado[pos], &resultado[(pos - 1) / 2])) {
+                    Vizinho temp = resultado[pos];
+                    resultado[pos] = resultado[(pos - 1) / 2];
+                    resultado[(pos - 1) / 2] = temp;
+                    pos = (pos - 1) / 2;
+                }
+            }
+            else if (piorVizinho(&resultado[0], &candidato)) {
+                resultado[0] = candidato;
+                descerVizinhos(resultado, total, 0);
+            }
+        }
+
+        // Subárvores esquerda e direita, com o retângulo cortado pela coordenada do ponto do meio
+        SubarvorePendente esq = s, dir = s;
+        esq.fim = meio;
+        dir.inicio = meio + 1;
+        esq.eixo = dir.eixo = 1 - s.eixo;
+        if (s.eixo == 0) {
+            esq.maxX = p->x;
+            dir.minX = p->x;
+        }
+        else {
+            esq.maxY = p->y;
+            dir.minY = p->y;
+        }
+        if (esq.inicio < esq.fim) {
+            esq.limite = distanciaRetangulo(&esq, x, y);
+            if (total < k || esq.limite <= resultado[0].distancia2) colocarPendente(pendentes, &numPendentes, &esq);
+        }
+        if (dir.inicio < dir.fim) {
+            dir.limite = distanciaRetangulo(&dir, x, y);
+            if (total < k || dir.limite <= resultado[0].distancia2) colocarPendente(pendentes, &numPendentes, &dir);
+        }
+    }
+
+    // Retira sucessivamente o pior para o fim, ficando o vetor por ordem crescente de distância
+    for (int fim = total - 1; fim > 0; fim--) {
+        Vizinho temp = resultado[0];
+        resultado[0] = resultado[fim];
+        resultado[fim] = temp;
+        descerVizinhos(resultado, fim, 0);
+    }
+    return total;
+}
+
+/// <summary>
+/// Procura as k antenas de uma frequência mais próximas de um ponto.
+/// </summary>
+/// <param name="a">Árvores de vizinhos.</param>
+/// <param name="freq">Frequência das antenas a procurar.</param>
+/// <param name="x">Coordenada X do ponto.</param>
+/// <param name="y">Coordenada Y do ponto.</param>
+/// <param name="k">Número de antenas pretendidas.</param>
+/// <param name="excluir">Índice de um vértice a ignorar (por exemplo, a própria antena), ou -1.</param>
+/// <param name="resultado">Vetor com pelo menos k posições, preenchido por ordem crescente de distância.</param>
+/// <returns>Número de antenas encontradas (pode ser inferior a k).</returns>
+int procurarVizinhosMaisProximos(const ArvoreVizinhos* a, char freq, int x, int y, int k, int excluir, Vizinho* resultado) {
+    int f = (unsigned char)freq;
+    int n = a->inicioFrequencia[f + 1] - a->inicioFrequencia[f];
+    SubarvorePendente* pendentes = malloc((n + 1) * sizeof(SubarvorePendente));
+    if (pendentes == NULL) {
+        perror("Erro na alocação da procura de vizinhos");
+        return 0;
+    }
+    int total = procurarNaArvore(a, f, x, y, k, excluir, resultado, pendentes);
+    free(pendentes);
+    return total;
+}
+
+/// <summary>
+/// Procura as k antenas de uma frequência mais próximas de cada um de vários pontos,
+/// reutilizando a mesma memória de trabalho em todas as consultas.
+/// </summary>
+/// <param name="a">Árvores de vizinhos.</param>
+/// <param name="freq">Frequência das antenas a procurar.</param>
+/// <param name="consultas">Pontos a consultar.</param>
+/// <param name="total">Número de pontos.</param>
+/// <param name="k">Número de antenas pretendidas por ponto.</param>
+/// <param name="resultados">Vetor com total * k posições; as antenas do ponto i começam na posição i * k.</param>
+/// <param name="encontrados">Vetor com total posições, com o número de antenas encontradas para cada ponto.</param>
+/// <returns>True em caso de sucesso; false em caso de erro de alocação.</returns>
+bool procurarVizinhosEmLote(const ArvoreVizinhos* a, char freq, const Coordenada* consultas, int total, int k,
+    Vizinho* resultados, int* encontrados) {
+    int f = (unsigned char)freq;
+    int n = a->inicioFrequencia[f + 1] - a->inicioFrequencia[f];
+    SubarvorePendente* pendentes = malloc((n + 1) * sizeof(SubarvorePendente));
+    if (pendentes == NULL) {
+        perror("Erro na alocação da procura de vizinhos");
+        return false;
+    }
+    for (int i = 0; i < total; i++) {
+        encontrados[i] = procurarNaArvore(a, f, consultas[i].x, consultas[i].y, k, -1, resultados + (size_t)i * k, pendentes);
+    }
+    free(pendentes);
+    return true;
+}
+
+/// <summary>
+/// Lista as k antenas de uma frequência mais próximas de um ponto, por ordem crescente de distância.
+/// Se existir uma antena no próprio ponto, essa antena não é incluída.
+/// </summary>
+/// <param name="g">Ponteiro para o grafo a partir do qual as árvores foram criadas.</param>
+/// <param name="a">Árvores de vizinhos.</param>
+/// <param name="freq">Frequência das antenas a procurar.</param>
+/// <param name="x">Coordenada X do ponto.</param>
+/// <param name="y">Coordenada Y do ponto.</param>
+/// <param name="k">Número de antenas a listar.</param>
+void listarVizinhosMaisProximos(Grafo* g, const ArvoreVizinhos* a, char freq, int x, int y, int k) {
+    if (k <= 0) return;
+    Vizinho* vizinhos = malloc(k * sizeof(Vizinho));
+    if (vizinhos == NULL) {
+        perror("Erro na alocação dos vizinhos");
+        return;
+    }
+
+    int n = procurarVizinhosMaisProximos(a, freq, x, y, k, encontrarIndicePorCoordenadas(g, x, y), vizinhos);
+    printf("\n%d antenas de frequencia '%c' mais proximas de (%d, %d):\n", n, freq, x, y);
+    for (int i = 0; i < n; i++) {
+        const Vertice* v = &g->vertices[vizinhos[i].vertice];
+        printf("  [%d] %c (%d, %d) | Distancia: %.2f\n", vizinhos[i].vertice, v->freq, v->x, v->y, sqrt((double)vizinhos[i].distancia2));
+    }
+    free(vizinhos);
+}
+
+#pragma endregion
@@ -0,0 +1,29 @@
+/*
+ *  @file funcoes_vizinhos.h
+ *  @author Rodrigo Pilar
+ *  @date 2025-07-28
+ *  @project EDA
+ *
+ *  Declarao das funes de procura das k antenas mais prximas de um ponto, por frequncia,
+ *  com rvores k-d.
+ */
+
+#ifndef FUNCOES_VIZINHOS_H
+#define FUNCOES_VIZINHOS_H
+
+#include <stdbool.h>
+#include "dados.h"
+
+// Criao e libertao
+bool criarArvoreVizinhos(Grafo* g, ArvoreVizinhos* a);
+void libertarArvoreVizinhos(ArvoreVizinhos* a);
+
+// Procura
+int procurarVizinhosMaisProximos(const ArvoreVizinhos* a, char freq, int x, int y, int k, int excluir, Vizinho* resultado);
+bool procurarVizinhosEmLote(const ArvoreVizinhos* a, char freq, const Coordenada* consultas, int total, int k,
+    Vizinho* resultados, int* encontrados);
+
+// Listagens
+void listarVizinhosMaisProximos(Grafo* g, const ArvoreVizinhos* a, char freq, int x, int y, int k);
+
+#endif // FUNCOES_VIZINHOS_H
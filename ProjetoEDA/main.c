@@ -13,12 +13,28 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "funcoes.h"
 #include "funcoes_grafos.h"
+#include "funcoes_raster.h"
+#include "funcoes_lote.h"
+#include "funcoes_interferencia.h"
+#include "funcoes_versoes.h"
+#include "funcoes_publicacao.h"
+#include "funcoes_servidor.h"
+#include "funcoes_distancias.h"
+#include "funcoes_pipeline.h"
+#include "funcoes_vizinhos.h"
+#include "funcoes_leitura.h"
 
 
 // Demonstrao completa das funcionalidades da Fase 1 e Fase 2 do projeto EDA
-int main() {
+int main(int argc, char* argv[]) {
+    // Modo servidor: carregar o mapa uma nica vez e responder a pedidos num socket local
+    if (argc == 4 && strcmp(argv[1], "--servidor") == 0) {
+        return executarServidor(argv[2], argv[3]) ? 0 : 1;
+    }
+
 #pragma region Fase 1 : Insero e Listagem de Antenas
        Antena* listaAntenas = NULL;
        int nRows, nCols;
@@ -60,10 +76,97 @@ int main() {
        imprimirMatriz(matriz, nRows);
        libertarMatriz(matriz, nRows);
 
+       // A mesma matriz na representao compacta, criada diretamente a partir da lista de antenas
+       RasterCompacto rasterLista;
+       if (criarRasterDeAntenas(listaAntenas, &rasterLista)) {
+           imprimirRasterCompacto(&rasterLista, stdout);
+           libertarRasterCompacto(&rasterLista);
+       }
+
+       // Imprimir a mesma matriz processando o ficheiro por bandas de 4 linhas, sem criar a matriz completa
+       imprimirFicheiroEmBandas("mapa.txt", 4);
+
+       // Imprimir a mesma matriz em pipeline: leitura, clculo dos nefastos (2 threads) e escrita em simultneo
+       imprimirFicheiroEmPipeline("mapa.txt", 4, 2, stdout);
+
        // Libertar memria antes de terminar
        libertarAntenas(listaAntenas);
 #pragma endregion
 
+#pragma region Representao Compacta do Mapa
+    // Criar a representao compacta (mapa de bits de nefastos e antenas esparsas) e comparar a memria usada
+    MapaFrequencias mapaFreq;
+    RasterCompacto raster;
+    inicializarMapaFrequencias(&mapaFreq);
+    if (carregarMapaFrequencias("mapa.txt", &mapaFreq) && criarRasterCompacto(&mapaFreq, &raster)) {
+        imprimirRasterCompacto(&raster, stdout);
+        printf("Celula (2, 9): %c | Memoria: %zu bytes (matriz: %zu bytes)\n",
+            consultarCelulaRaster(&raster, 2, 9), memoriaRasterCompacto(&raster), memoriaMatrizEquivalente(&raster));
+        libertarRasterCompacto(&raster);
+    }
+
+    // Modo harmnico: todas as clulas alinhadas com um par de antenas da mesma frequncia so nefastas
+    if (criarRasterHarmonico(&mapaFreq, &raster)) {
+        imprimirRasterCompacto(&raster, stdout);
+        printf("Nefastos harmonicos: %lld\n", (long long)contarNefastosRaster(&raster));
+        libertarRasterCompacto(&raster);
+    }
+
+    // Desenhar apenas uma janela de 5x6 clulas a partir de (2, 4), usando ndices espaciais
+    IndiceEspacial indiceAntenas, indiceNefastos;
+    if (criarIndiceAntenas(&mapaFreq, &indiceAntenas)) {
+        if (criarIndiceNefastos(&mapaFreq, &indiceNefastos)) {
+            imprimirJanela(&indiceAntenas, &indiceNefastos, 2, 4, 5, 6, stdout);
+            libertarIndiceEspacial(&indiceNefastos);
+        }
+        libertarIndiceEspacial(&indiceAntenas);
+    }
+
+    // Contar quantos pares de antenas atingem cada clula e listar as 5 clulas mais atingidas
+    MapaInterferencia interferencia;
+    if (criarMapaInterferencia(&mapaFreq, &interferencia)) {
+        listarCelulasMaisCriticas(&interferencia, 5);
+        libertarMapaInterferencia(&interferencia);
+    }
+    libertarMapaFrequencias(&mapaFreq);
+#pragma endregion
+
+#pragma region Verses de Antenas
+    // Criar um cenrio a partir do mapa original (sem copiar as antenas) e comparar os resultados
+    Antena* antenasBase = carregarAntenasDeFicheiro("mapa.txt", NULL);
+    VersaoAntenas* versaoBase = criarVersaoAntenas(antenasBase);
+    libertarAntenas(antenasBase);
+    if (versaoBase != NULL) {
+        VersaoAntenas* cenario = bifurcarVersao(versaoBase);
+        if (cenario != NULL) {
+            removerAntenaVersao(cenario, 2, 9);
+            adicionarAntenaVersao(cenario, 'A', 12, 12);
+            listarDiferencasVersoes(versaoBase, cenario);
+            printf("Nefastos: %d -> %d | Componentes: %d -> %d\n",
+                contarNefastosVersao(versaoBase), contarNefastosVersao(cenario),
+                contarComponentesVersao(versaoBase), contarComponentesVersao(cenario));
+            libertarVersao(cenario);
+        }
+        libertarVersao(versaoBase);
+    }
+#pragma endregion
+
+#pragma region Processamento em Lote
+    // Processar vrios ficheiros de mapa em paralelo e apresentar os resultados pela ordem dos ficheiros
+    const char* ficheirosLote[] = { "mapa.txt", "mapa2.txt" };
+    ResultadoMapa resultadosLote[2];
+    processarLoteMapas(ficheirosLote, 2, 2, resultadosLote);
+    imprimirResultadosLote(resultadosLote, 2, stdout);
+
+    // Carregar um mapa dividido em blocos de linhas lidos por vrias threads (mesmo resultado de carregarMapaFrequencias)
+    MapaFrequencias mapaParalelo;
+    inicializarMapaFrequencias(&mapaParalelo);
+    if (carregarMapaFrequenciasParalelo("mapa.txt", &mapaParalelo, 4)) {
+        printf("Mapa lido em paralelo: %dx%d, %d antenas\n", mapaParalelo.nLinhas, mapaParalelo.nColunas, mapaParalelo.totalAntenas);
+    }
+    libertarMapaFrequencias(&mapaParalelo);
+#pragma endregion
+
 #pragma region Fase 2 : Representao com Grafos
     // Inicializar grafo e carregar as antenas do ficheiro
     Grafo g;
@@ -88,6 +191,66 @@ int main() {
     // Listar os pares de antenas com frequncias diferentes ('A' e '0') cuja distncia real entre si seja inferior ou igual a 10 unidades
     listarIntersecoesEntreFrequencias(&g, 'A', '0', 10);
 
+    // Calcular as distncias em saltos entre todas as antenas (64 origens por passagem) e o dimetro do grafo
+    MatrizDistancias distancias;
+    if (calcularDistanciasGrafo(&g, &distancias, true)) {
+        listarExcentricidades(&g, &distancias);
+        printf("Distancia entre [0] e [3]: %d\n", distanciaSaltos(&distancias, 0, 3));
+        libertarMatrizDistancias(&distancias);
+    }
+
+    // Procurar as 3 antenas de frequncia 'A' mais prximas de (5, 5), com uma rvore k-d por frequncia
+    ArvoreVizinhos arvore;
+    if (criarArvoreVizinhos(&g, &arvore)) {
+        listarVizinhosMaisProximos(&g, &arvore, 'A', 5, 5, 3);
+        libertarArvoreVizinhos(&arvore);
+    }
+
+    // Adicionar e remover antenas sem reconstruir todas as ligaes do grafo
+    adicionarAntenaGrafo(&g, 'A', 11, 11);
+    removerAntenaGrafo(&g, 1, 8);
+    listarArestasGrafo(g);
+
+    // Libertar as ligaes do grafo antes de terminar
+    libertarGrafo(&g);
+
+#pragma endregion
+
+#pragma region Leitura Concorrente do Grafo
+    // Publicar o grafo para leitura sem trincos: a verso lida mantm-se vlida enquanto o escritor publica outra
+    GrafoPublicado publicado;
+    if (iniciarGrafoPublicado(&publicado, "mapa.txt")) {
+        int leitor = registarLeitor(&publicado);
+        int ordem[MAX_VERTICES];
+
+        const GrafoImutavel* versaoLida = entrarLeitura(&publicado, leitor);
+        adicionarAntenaPublicada(&publicado, 'A', 11, 11);
+        printf("\nVersao lida: %d antenas, BFS a partir de (1, 8) visita %d, %d intersecoes A-0\n",
+            versaoLida->tamanho, bfsImutavel(versaoLida, procurarIndiceImutavel(versaoLida, 1, 8), ordem),
+            intersecoesImutavel(versaoLida, 'A', '0', 10, NULL, 0));
+        sairLeitura(&publicado, leitor);
+
+        versaoLida = entrarLeitura(&publicado, leitor);
+        printf("Versao publicada: %d antenas\n", versaoLida->tamanho);
+        sairLeitura(&publicado, leitor);
+
+        retirarLeitor(&publicado, leitor);
+        terminarGrafoPublicado(&publicado);
+    }
+#pragma endregion
+
+#pragma region Servidor de Consultas
+    // Responder a um lote de pedidos do protocolo do servidor, sem abrir o socket
+    EstadoServidor estadoServidor;
+    if (carregarEstadoServidor(&estadoServidor, "mapa.txt")) {
+        const char* pedidos = "CAMINHO 2 9 5 5\nALCANCAVEL 2 9 6 7\nNEFASTO 1 7\nJANELA 1 6 3 4\n";
+        TextoResposta resposta = { NULL, 0, 0 };
+        size_t consumidos;
+        responderLote(&estadoServidor, pedidos, strlen(pedidos), &consumidos, &resposta);
+        printf("\nPedidos:\n%sRespostas:\n%.*s", pedidos, (int)resposta.tamanho, resposta.dados);
+        libertarTextoResposta(&resposta);
+        libertarEstadoServidor(&estadoServidor);
+    }
 #pragma endregion
 
     return 0;